@@ -15,6 +15,14 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>      // for memset
+#include <new>          // for placement new
+#include <algorithm>    // for fill_n
+#include "iterator_traits.h"
+#include <mutex>        // for 多线程版本的次级配置器
+#include <type_traits>  // for 编译期选择memchr、memcmp
+#include "simd_kernels.h"
+#include "type_traits.h"
 
 
 namespace LYH
@@ -26,6 +34,20 @@ namespace LYH
         new(p) T1(value);
     }
 
+    // 以默认构造函数构造
+    template <class T1>
+    inline void construct( T1* p )
+    {
+        new(p) T1();
+    }
+
+    // 取出原生指针所指之物的型别，供destroy、uninitialized_fill_n做型别推导
+    template <class T>
+    inline T* value_type( const T* )
+    {
+        return static_cast<T*>(0);
+    }
+
     // destroy第一个版本，接受一个指针
     template <class T>
     inline void destroy( T* p )
@@ -33,14 +55,19 @@ namespace LYH
         p->~T();
     }
 
-    // destroy第二个版本，接受两个迭代器
-    // 接口
+    // 如果有non-trivial dtor
     template <class ForwardIterator>
-    inline void destroy( ForwardIterator first, ForwardIterator last )
+    inline void __destroy_aux( ForwardIterator first, ForwardIterator last, __false_type )
     {
-        __destroy( first, last, value_type( first ) );
+        for( ; first != last; ++first )
+            destroy( &*first );
     }
 
+    // 如果有trivial dtor
+    template <class ForwardIterator>
+    inline void __destroy_aux( ForwardIterator, ForwardIterator, __true_type )
+    {}  // 内置类型，什么都不做，把空间还回去即可
+
     // 判断元素的数值型别是否有trivial dtor
     template <class ForwardIterator, class T>
     inline void __destroy( ForwardIterator first, ForwardIterator last, T* )
@@ -49,19 +76,14 @@ namespace LYH
         __destroy_aux( first, last, trivial_destructor() );
     }
 
-    // 如果有non-trivial dtor
+    // destroy第二个版本，接受两个迭代器
+    // 接口
     template <class ForwardIterator>
-    inline void __destroy_aux( ForwardIterator first, ForwardIterator last, __false_type )
+    inline void destroy( ForwardIterator first, ForwardIterator last )
     {
-        for( ; first < last; first++ )
-            destroy( &*first );
+        __destroy( first, last, value_type( first ) );
     }
 
-    // 如果有trivial dtor
-    template <class ForwardIterator>
-    inline void __destroy_aux( ForwardIterator first, ForwardIterator last, __true_type )
-    {}  // 内置类型，什么都不做，把空间还回去即可
-
 
     // 统一接口
     template <class T, class Alloc>
@@ -76,6 +98,9 @@ namespace LYH
             { if( 0 != n ) Alloc::deallocate( p, n * sizeof(T) ); }
         static void deallocate( T* p )
             { Alloc::deallocate( p, sizeof(T) ); }
+        // 归还一串以第一个字串接的区块，由head串到tail
+        static void deallocate_chain( T* head, T* tail )
+            { Alloc::deallocate_chain( head, tail, sizeof(T) ); }
     };
 
     template <int inst>
@@ -102,6 +127,21 @@ namespace LYH
             free(p);    // 第一级配置器直接使用free()
         }
 
+        // 归还一串区块，区块之间以各自的第一个字串接，由head串到tail
+        // 第一级配置器只能逐块free()
+        static void deallocate_chain( void* head, void* tail, size_t )
+        {
+            for(;;)
+            {
+                void* next = *static_cast<void**>( head );
+                bool done = head == tail;
+                free( head );
+                if( done )
+                    break;
+                head = next;
+            }
+        }
+
         static void* reallocate( void* p, size_t /* old_sz */, size_t new_sz )
         {
             void* result = realloc( p, new_sz );        // 第一级配置器直接使用realloc
@@ -205,6 +245,20 @@ namespace LYH
         static char* end_free;          // heap结束位置，只在chunk_alloc中变化
         static size_t heap_size;
 
+        // threads为true时，free lists与内存池由一个互斥锁保护
+        // refill与chunk_alloc只在allocate持有锁时被调用，不必另外加锁
+        static std::mutex& node_allocator_mutex()
+        {
+            static std::mutex m;
+            return m;
+        }
+        class lock
+        {
+        public:
+            lock() { if( threads ) node_allocator_mutex().lock(); }
+            ~lock() { if( threads ) node_allocator_mutex().unlock(); }
+        };
+
     public:
         // 配置空间
         // n must > 0
@@ -216,9 +270,10 @@ namespace LYH
             // 如果大于128就调用一级配置器
             if( n > (size_t) __MAX_BYTES )
                 return ( malloc_alloc::allocate(n) );
+            lock guard;
             // 在16个free lists中寻找适当的一个头节点
             my_free_list = free_list + FREELIST_INDEX(n);
-            result = my_free_list;
+            result = *my_free_list;
             if( nullptr == result )
             {
                 // 没找到可用的free list，准备重新填充
@@ -244,6 +299,7 @@ namespace LYH
                 malloc_alloc::deallocate( p, n );
                 return;
             }
+            lock guard;
             // 寻找对应的free list
             my_free_list = free_list + FREELIST_INDEX( n );
 
@@ -252,6 +308,23 @@ namespace LYH
             q->free_list_link = *my_free_list;
             *my_free_list = q;
         }
+
+        // 一次归还一串大小均为n的区块
+        // 区块之间以各自的第一个字(即free_list_link)串接，由head串到tail，tail的链接会被改写
+        // 整串直接接到free list的前端，不必逐块处理
+        static void deallocate_chain( void* head, void* tail, size_t n )
+        {
+            // 大于128就交给一级配置器
+            if( n > (size_t) __MAX_BYTES )
+            {
+                malloc_alloc::deallocate_chain( head, tail, n );
+                return;
+            }
+            lock guard;
+            obj* volatile * my_free_list = free_list + FREELIST_INDEX( n );
+            ( (obj*) tail )->free_list_link = *my_free_list;
+            *my_free_list = (obj*) head;
+        }
     };
 
     // 初值设定
@@ -267,7 +340,7 @@ namespace LYH
     template <bool threads, int inst>
     typename __default_alloc_template<threads, inst>::obj* volatile
     __default_alloc_template<threads, inst>::free_list[__NFREELISTS] =
-    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 
     // 返回一个free list节点供客户端使用，并重新填充该free list（调用refill意味着原先的已经用完）
     // 这里的n已经处理为8的倍数
@@ -355,7 +428,7 @@ namespace LYH
                 obj * volatile * my_free_list, *p;
                 for( int i = size; i <= __MAX_BYTES; i += __ALIGN )
                 {
-                    my_free_list = free_list + FREELIST_INDEX( size );
+                    my_free_list = free_list + FREELIST_INDEX( i );
                     p = *my_free_list;
                     if( 0 != p )
                     {
@@ -376,24 +449,121 @@ namespace LYH
                 // 递归调用自己，修正nobjs
                 return ( chunk_alloc( size, nobjs ) );
             }
+            heap_size += bytes_to_get;
+            end_free = start_free + bytes_to_get;
+            // 内存池已补充，递归调用自己，修正nobjs
+            return ( chunk_alloc( size, nobjs ) );
         }
     }
 
     typedef __default_alloc_template<false,0> alloc;
+    // 多线程共用的次级配置器，每次配置与释放都要加锁
+    typedef __default_alloc_template<true,0> threaded_alloc;
 
-    template <class ForwardIterator, class Size, class T>
-    inline ForwardIterator uninitialized_fill_n( ForwardIterator first,
-                                                 Size n, const T& x )
+    // 配置器能否同时被多个线程使用
+    template <class Alloc>
+    struct __alloc_thread_safe { static const bool value = false; };
+    template <int inst>
+    struct __alloc_thread_safe< __malloc_alloc_template<inst> > { static const bool value = true; };
+    template <int inst>
+    struct __alloc_thread_safe< __default_alloc_template<true, inst> > { static const bool value = true; };
+
+    // 对齐的配置器：传回的区块地址是Align的倍数，Align须为2的幂且不小于一个指针
+    // 供需要按cache line或page对齐的缓冲区使用(例如deque的缓冲区)，不经过内存池
+    template <size_t Align>
+    class __aligned_alloc
     {
-        return __uninitialized_fill_n( first, n, x, value_type( first ) );
+        static_assert( ( Align & ( Align - 1 ) ) == 0 && Align >= sizeof(void*),
+                       "Align must be a power of two no smaller than a pointer" );
+    public:
+        static void* allocate( size_t n )
+        {
+#if defined( __unix__ ) || defined( __APPLE__ )
+            void* result = 0;
+            if( posix_memalign( &result, Align, n ) != 0 )
+                result = 0;
+            if( 0 == result ) { __THROW_BAD_ALLOC; }
+            return result;
+#else
+            // 多配置Align个字节，原始地址存放在对齐地址之前的一个字中
+            char* raw = (char*) malloc_alloc::allocate( n + Align );
+            char* result = (char*)( ( (size_t) raw + Align ) & ~( Align - 1 ) );
+            ( (void**) result )[-1] = raw;
+            return result;
+#endif
+        }
+        static void deallocate( void* p, size_t )
+        {
+#if defined( __unix__ ) || defined( __APPLE__ )
+            free( p );
+#else
+            free( ( (void**) p )[-1] );
+#endif
+        }
+        // 归还一串以第一个字串接的区块，只能逐块归还
+        static void deallocate_chain( void* head, void* tail, size_t n )
+        {
+            for(;;)
+            {
+                void* next = *static_cast<void**>( head );
+                bool done = head == tail;
+                deallocate( head, n );
+                if( done )
+                    break;
+                head = next;
+            }
+        }
+    };
+
+    template <size_t Align>
+    struct __alloc_thread_safe< __aligned_alloc<Align> > { static const bool value = true; };
+
+    // POD型别的填充，迭代器为原生指针时：
+    // 元素只有一个字节，或填充值的每个字节都是0（例如T()），直接交给memset
+    // 其余情况交给fill_n，编译器会将其向量化为广播存储
+    template <class T, class Size>
+    inline T* __fill_n_pod( T* first, Size n, const T& x )
+    {
+        if( n <= 0 )
+            return first;
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>( &x );
+        bool all_zero = true;
+        for( size_t i = 0; i < sizeof(T); ++i )
+        {
+            if( bytes[i] != 0 )
+            {
+                all_zero = false;
+                break;
+            }
+        }
+        if( sizeof(T) == 1 || all_zero )
+        {
+            memset( first, bytes[0], size_t(n) * sizeof(T) );
+            return first + n;
+        }
+        // 元素大小整除32且区间够大时交给SIMD核心，以元素重复排列出的样板做广播存储
+        if( 32 % sizeof(T) == 0 && size_t(n) * sizeof(T) >= 64 )
+        {
+            unsigned char pattern[64];
+            for( size_t i = 0; i < 64; i += sizeof(T) )
+                memcpy( pattern + i, &x, sizeof(T) );
+            __simd_fill_bytes( first, size_t(n) * sizeof(T), pattern );
+            return first + n;
+        }
+        return std::fill_n( first, n, x );
     }
-    // 萃取出迭代器first的value type，然后判断该类型是否为POD
-    template <class ForwardIterator, class Size, class T, class T1>
-    inline ForwardIterator __uninitialized_fill_n( ForwardIterator first, Size n,
-                                                   const T& x, T1* )
+    // 填充值与元素的型别不同时(例如以0填充long)，先转换为元素的型别，再走上面的快速路径
+    template <class T, class Size, class V>
+    inline T* __fill_n_pod( T* first, Size n, const V& value )
+    {
+        const T x = value;
+        return __fill_n_pod( first, n, x );
+    }
+    // 一般迭代器
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator __fill_n_pod( ForwardIterator first, Size n, const T& x )
     {
-        typedef typename __type_traits<T1>::is_POD_type is_POD();
-        return __uninitialized_fill_n_aux( first, n, x, is_POD );
+        return std::fill_n( first, n, x );
     }
 
     // 如果copy construction 等同于 assignment
@@ -403,7 +573,7 @@ namespace LYH
     inline ForwardIterator __uninitialized_fill_n_aux( ForwardIterator first,
                                                        Size n, const T& x, __true_type )
     {
-        return fill_n( first, n, x );       // 交由高阶函数执行
+        return __fill_n_pod( first, n, x );       // 交由高阶函数执行
     }
     // 如果不是POD型别
     template <class ForwardIterator, class Size, class T>
@@ -413,8 +583,415 @@ namespace LYH
         ForwardIterator cur = first;
         for( ; n > 0; --n, ++cur )
         {
-            constrcut( &*cur, x );
+            construct( &*cur, x );
+        }
+        return cur;
+    }
+
+    // 萃取出迭代器first的value type，然后判断该类型是否为POD
+    template <class ForwardIterator, class Size, class T, class T1>
+    inline ForwardIterator __uninitialized_fill_n( ForwardIterator first, Size n,
+                                                   const T& x, T1* )
+    {
+        typedef typename __type_traits<T1>::is_POD_type is_POD;
+        return __uninitialized_fill_n_aux( first, n, x, is_POD() );
+    }
+
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator uninitialized_fill_n( ForwardIterator first,
+                                                 Size n, const T& x )
+    {
+        return __uninitialized_fill_n( first, n, x, value_type( first ) );
+    }
+
+    // fill_n、fill：元素为POD型别时，assignment与copy construction等价，走__fill_n_pod
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator __fill_n_aux( ForwardIterator first, Size n, const T& x, __true_type )
+    {
+        return __fill_n_pod( first, n, x );
+    }
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator __fill_n_aux( ForwardIterator first, Size n, const T& x, __false_type )
+    {
+        return std::fill_n( first, n, x );
+    }
+    template <class ForwardIterator, class Size, class T, class T1>
+    inline ForwardIterator __fill_n( ForwardIterator first, Size n, const T& x, T1* )
+    {
+        typedef typename __type_traits<T1>::is_POD_type is_POD;
+        return __fill_n_aux( first, n, x, is_POD() );
+    }
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator fill_n( ForwardIterator first, Size n, const T& x )
+    {
+        return __fill_n( first, n, x, value_type( first ) );
+    }
+    // fill依迭代器类型分派：单向逐一赋值，
+    // 随机存取迭代器可以直接算出元素个数，交给fill_n(原生指针由此走memset、SIMD核心)
+    template <class ForwardIterator, class T>
+    inline void __fill( ForwardIterator first, ForwardIterator last, const T& x, forward_iterator_tag )
+    {
+        for( ; first != last; ++first )
+            *first = x;
+    }
+    template <class RandomAccessIterator, class T>
+    inline void __fill( RandomAccessIterator first, RandomAccessIterator last, const T& x, random_access_iterator_tag )
+    {
+        LYH::fill_n( first, last - first, x );
+    }
+    template <class ForwardIterator, class T>
+    inline void fill( ForwardIterator first, ForwardIterator last, const T& x )
+    {
+        LYH::__fill( first, last, x, iterator_category( first ) );
+    }
+
+    // copy、copy_backward：原生指针且元素有trivial assignment operator时，交给SIMD核心逐字节搬移
+    template <class T>
+    inline T* __copy_t( const T* first, const T* last, T* result, __true_type )
+    {
+        __simd_copy_bytes( result, first, size_t( last - first ) * sizeof(T) );
+        return result + ( last - first );
+    }
+    template <class T>
+    inline T* __copy_t( const T* first, const T* last, T* result, __false_type )
+    {
+        return std::copy( first, last, result );
+    }
+    // 一般迭代器的copy依迭代器类型分派：
+    // 单向以迭代器是否相等判断循环结束，随机存取以元素个数控制循环，比较整数比比较迭代器快
+    template <class InputIterator, class OutputIterator>
+    inline OutputIterator __copy( InputIterator first, InputIterator last, OutputIterator result, input_iterator_tag )
+    {
+        for( ; first != last; ++first, ++result )
+            *result = *first;
+        return result;
+    }
+    template <class RandomAccessIterator, class OutputIterator>
+    inline OutputIterator __copy( RandomAccessIterator first, RandomAccessIterator last, OutputIterator result,
+                                  random_access_iterator_tag )
+    {
+        typedef typename iterator_traits<RandomAccessIterator>::difference_type Distance;
+        for( Distance n = last - first; n > 0; --n, ++first, ++result )
+            *result = *first;
+        return result;
+    }
+    template <class InputIterator, class OutputIterator>
+    inline OutputIterator copy( InputIterator first, InputIterator last, OutputIterator result )
+    {
+        return LYH::__copy( first, last, result, iterator_category( first ) );
+    }
+    template <class T>
+    inline T* copy( const T* first, const T* last, T* result )
+    {
+        typedef typename __type_traits<T>::has_trivial_assignment_operator t;
+        return __copy_t( first, last, result, t() );
+    }
+    template <class T>
+    inline T* copy( T* first, T* last, T* result )
+    {
+        return LYH::copy( (const T*) first, (const T*) last, result );
+    }
+
+    template <class T>
+    inline T* __copy_backward_t( const T* first, const T* last, T* result, __true_type )
+    {
+        __simd_copy_backward_bytes( result, last, size_t( last - first ) * sizeof(T) );
+        return result - ( last - first );
+    }
+    template <class T>
+    inline T* __copy_backward_t( const T* first, const T* last, T* result, __false_type )
+    {
+        return std::copy_backward( first, last, result );
+    }
+    template <class BidirectionalIterator1, class BidirectionalIterator2>
+    inline BidirectionalIterator2 copy_backward( BidirectionalIterator1 first, BidirectionalIterator1 last,
+                                                 BidirectionalIterator2 result )
+    {
+        return std::copy_backward( first, last, result );
+    }
+    template <class T>
+    inline T* copy_backward( const T* first, const T* last, T* result )
+    {
+        typedef typename __type_traits<T>::has_trivial_assignment_operator t;
+        return __copy_backward_t( first, last, result, t() );
+    }
+    template <class T>
+    inline T* copy_backward( T* first, T* last, T* result )
+    {
+        return LYH::copy_backward( (const T*) first, (const T*) last, result );
+    }
+
+    // find、equal、lexicographical_compare：迭代器为原生指针、元素的值可以逐字节比较时，
+    // 编译期改走memchr、memcmp，其余情形逐一比较
+    // 整数、enum与指针的相等就是逐字节相等；浮点数(+0.0与-0.0、NaN)与一般的class不是
+    template <class T>
+    struct __is_bitwise_comparable
+        : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value> {};
+
+    // memchr以unsigned char比较，只适用于一个字节的整数型别
+    template <class InputIterator, class T>
+    struct __find_use_memchr
+    {
+        typedef typename iterator_traits<InputIterator>::value_type value_type;
+        typedef typename std::conditional< std::is_pointer<InputIterator>::value
+                                           && std::is_integral<value_type>::value && sizeof(value_type) == 1
+                                           && std::is_integral<T>::value,
+                                           __true_type, __false_type >::type type;
+    };
+    template <class InputIterator, class T>
+    inline InputIterator __find( InputIterator first, InputIterator last, const T& value, __false_type )
+    {
+        while( first != last && !( *first == value ) )
+            ++first;
+        return first;
+    }
+    template <class Pointer, class T>
+    inline Pointer __find( Pointer first, Pointer last, const T& value, __true_type )
+    {
+        typedef typename iterator_traits<Pointer>::value_type value_type;
+        // value不在元素的值域内(例如在char中找300)时不可能相等，不能截断后交给memchr
+        if( first == last || static_cast<T>( static_cast<value_type>( value ) ) != value )
+            return last;
+        const void* p = memchr( first, static_cast<unsigned char>( static_cast<value_type>( value ) ), size_t( last - first ) );
+        return p != 0 ? first + ( static_cast<const value_type*>( p ) - first ) : last;
+    }
+    template <class InputIterator, class T>
+    inline InputIterator find( InputIterator first, InputIterator last, const T& value )
+    {
+        return LYH::__find( first, last, value, typename __find_use_memchr<InputIterator, T>::type() );
+    }
+
+    // 两边都是指向同一型别(不计const)的原生指针，且该型别可以逐字节比较时使用memcmp
+    template <class InputIterator1, class InputIterator2>
+    struct __equal_use_memcmp
+    {
+        typedef typename iterator_traits<InputIterator1>::value_type value_type1;
+        typedef typename iterator_traits<InputIterator2>::value_type value_type2;
+        typedef typename std::conditional< std::is_pointer<InputIterator1>::value && std::is_pointer<InputIterator2>::value
+                                           && std::is_same<value_type1, value_type2>::value
+                                           && __is_bitwise_comparable<value_type1>::value,
+                                           __true_type, __false_type >::type type;
+    };
+    template <class InputIterator1, class InputIterator2>
+    inline bool __equal( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, __false_type )
+    {
+        for( ; first1 != last1; ++first1, ++first2 )
+            if( !( *first1 == *first2 ) )
+                return false;
+        return true;
+    }
+    template <class Pointer1, class Pointer2>
+    inline bool __equal( Pointer1 first1, Pointer1 last1, Pointer2 first2, __true_type )
+    {
+        size_t bytes = size_t( last1 - first1 ) * sizeof( *first1 );
+        return bytes == 0 || memcmp( first1, first2, bytes ) == 0;
+    }
+    template <class InputIterator1, class InputIterator2>
+    inline bool equal( InputIterator1 first1, InputIterator1 last1, InputIterator2 first2 )
+    {
+        return LYH::__equal( first1, last1, first2, typename __equal_use_memcmp<InputIterator1, InputIterator2>::type() );
+    }
+
+    // memcmp以unsigned char比较大小，只有元素本身就是无号的单字节型别时次序才一致
+    template <class InputIterator1, class InputIterator2>
+    struct __lexicographical_compare_use_memcmp
+    {
+        typedef typename iterator_traits<InputIterator1>::value_type value_type1;
+        typedef typename iterator_traits<InputIterator2>::value_type value_type2;
+        typedef typename std::conditional< std::is_pointer<InputIterator1>::value && std::is_pointer<InputIterator2>::value
+                                           && std::is_same<value_type1, value_type2>::value
+                                           && std::is_integral<value_type1>::value && std::is_unsigned<value_type1>::value
+                                           && sizeof(value_type1) == 1 && !std::is_same<value_type1, bool>::value,
+                                           __true_type, __false_type >::type type;
+    };
+    template <class InputIterator1, class InputIterator2>
+    inline bool __lexicographical_compare( InputIterator1 first1, InputIterator1 last1,
+                                           InputIterator2 first2, InputIterator2 last2, __false_type )
+    {
+        for( ; first1 != last1 && first2 != last2; ++first1, ++first2 )
+        {
+            if( *first1 < *first2 )
+                return true;
+            if( *first2 < *first1 )
+                return false;
+        }
+        return first1 == last1 && first2 != last2;
+    }
+    template <class Pointer1, class Pointer2>
+    inline bool __lexicographical_compare( Pointer1 first1, Pointer1 last1,
+                                           Pointer2 first2, Pointer2 last2, __true_type )
+    {
+        size_t len1 = size_t( last1 - first1 );
+        size_t len2 = size_t( last2 - first2 );
+        size_t n = len1 < len2 ? len1 : len2;
+        int r = n == 0 ? 0 : memcmp( first1, first2, n );
+        return r != 0 ? r < 0 : len1 < len2;
+    }
+    template <class InputIterator1, class InputIterator2>
+    inline bool lexicographical_compare( InputIterator1 first1, InputIterator1 last1,
+                                         InputIterator2 first2, InputIterator2 last2 )
+    {
+        return LYH::__lexicographical_compare( first1, last1, first2, last2,
+                   typename __lexicographical_compare_use_memcmp<InputIterator1, InputIterator2>::type() );
+    }
+
+    // 对每个元素执行f
+    template <class InputIterator, class Function>
+    inline Function for_each( InputIterator first, InputIterator last, Function f )
+    {
+        for( ; first != last; ++first )
+            f( *first );
+        return f;
+    }
+
+    // 累加
+    template <class InputIterator, class T>
+    inline T accumulate( InputIterator first, InputIterator last, T init )
+    {
+        for( ; first != last; ++first )
+            init = init + *first;
+        return init;
+    }
+    template <class InputIterator, class T, class BinaryOperation>
+    inline T accumulate( InputIterator first, InputIterator last, T init, BinaryOperation op )
+    {
+        for( ; first != last; ++first )
+            init = op( init, *first );
+        return init;
+    }
+
+    // uninitialized_copy：POD型别等同于copy
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator __uninitialized_copy_aux( InputIterator first, InputIterator last,
+                                                     ForwardIterator result, __true_type )
+    {
+        return LYH::copy( first, last, result );
+    }
+    // 如果不是POD型别，逐个构造，中途抛出异常则析构已构造的元素(commit or rollback)
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator __uninitialized_copy_aux( InputIterator first, InputIterator last,
+                                                     ForwardIterator result, __false_type )
+    {
+        ForwardIterator cur = result;
+        try
+        {
+            for( ; first != last; ++first, ++cur )
+                construct( &*cur, *first );
+        }
+        catch(...)
+        {
+            destroy( result, cur );
+            throw;
+        }
+        return cur;
+    }
+    template <class InputIterator, class ForwardIterator, class T>
+    inline ForwardIterator __uninitialized_copy( InputIterator first, InputIterator last,
+                                                 ForwardIterator result, T* )
+    {
+        typedef typename __type_traits<T>::is_POD_type is_POD;
+        return __uninitialized_copy_aux( first, last, result, is_POD() );
+    }
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator uninitialized_copy( InputIterator first, InputIterator last,
+                                               ForwardIterator result )
+    {
+        return __uninitialized_copy( first, last, result, value_type( result ) );
+    }
+
+    // uninitialized_fill：POD型别等同于fill
+    template <class ForwardIterator, class T>
+    inline void __uninitialized_fill_aux( ForwardIterator first, ForwardIterator last,
+                                          const T& x, __true_type )
+    {
+        LYH::fill( first, last, x );
+    }
+    // 如果不是POD型别，逐个构造，中途抛出异常则析构已构造的元素
+    template <class ForwardIterator, class T>
+    inline void __uninitialized_fill_aux( ForwardIterator first, ForwardIterator last,
+                                          const T& x, __false_type )
+    {
+        ForwardIterator cur = first;
+        try
+        {
+            for( ; cur != last; ++cur )
+                construct( &*cur, x );
+        }
+        catch(...)
+        {
+            destroy( first, cur );
+            throw;
+        }
+    }
+    template <class ForwardIterator, class T, class T1>
+    inline void __uninitialized_fill( ForwardIterator first, ForwardIterator last,
+                                      const T& x, T1* )
+    {
+        typedef typename __type_traits<T1>::is_POD_type is_POD;
+        __uninitialized_fill_aux( first, last, x, is_POD() );
+    }
+    template <class ForwardIterator, class T>
+    inline void uninitialized_fill( ForwardIterator first, ForwardIterator last, const T& x )
+    {
+        __uninitialized_fill( first, last, x, value_type( first ) );
+    }
+
+    // 默认初始化n个元素
+    // POD型别的默认初始化什么都不做，空间保留原来的内容，省去一次填充
+    template <class ForwardIterator, class Size>
+    inline ForwardIterator __uninitialized_default_n_aux( ForwardIterator first,
+                                                          Size n, __true_type )
+    {
+        LYH::advance( first, n );
+        return first;
+    }
+    // 如果不是POD型别，逐个调用默认构造函数
+    template <class ForwardIterator, class Size>
+    inline ForwardIterator __uninitialized_default_n_aux( ForwardIterator first,
+                                                          Size n, __false_type )
+    {
+        ForwardIterator cur = first;
+        for( ; n > 0; --n, ++cur )
+        {
+            construct( &*cur );
         }
+        return cur;
+    }
+
+    template <class ForwardIterator, class Size, class T>
+    inline ForwardIterator __uninitialized_default_n( ForwardIterator first, Size n, T* )
+    {
+        typedef typename __type_traits<T>::is_POD_type is_POD;
+        return __uninitialized_default_n_aux( first, n, is_POD() );
+    }
+
+    template <class ForwardIterator, class Size>
+    inline ForwardIterator uninitialized_default_n( ForwardIterator first, Size n )
+    {
+        return __uninitialized_default_n( first, n, value_type( first ) );
+    }
+
+    // 把[first, last)的元素搬到未初始化的result，传回搬移后的尾端，搬完后原空间视为未初始化
+    // trivially relocatable的元素整块逐字节搬移，原位置不必析构
+    template <class T>
+    inline T* __uninitialized_relocate( T* first, T* last, T* result, __true_type )
+    {
+        __simd_copy_bytes( result, first, size_t( last - first ) * sizeof(T) );
+        return result + ( last - first );
+    }
+    // 其余的型别复制后析构原元素，复制中途抛出异常时原元素保持不变
+    template <class T>
+    inline T* __uninitialized_relocate( T* first, T* last, T* result, __false_type )
+    {
+        T* cur = LYH::uninitialized_copy( first, last, result );
+        destroy( first, last );
+        return cur;
+    }
+    template <class T>
+    inline T* uninitialized_relocate( T* first, T* last, T* result )
+    {
+        typedef typename __type_traits<T>::has_trivial_relocate trivial_relocate;
+        return __uninitialized_relocate( first, last, result, trivial_relocate() );
     }
 };
 
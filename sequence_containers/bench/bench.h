@@ -0,0 +1,48 @@
+//
+// 基准测试共用的计时与输出工具
+//
+
+#ifndef SEQUENCE_CONTAINERS_BENCH_H
+#define SEQUENCE_CONTAINERS_BENCH_H
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// 执行f一次，传回经过的秒数
+template <class F>
+inline double bench_time( F f )
+{
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() - t0 ).count();
+}
+
+// 执行f共reps次，传回最短的一次，减少其他进程干扰
+template <class F>
+inline double bench_best( int reps, F f )
+{
+    double best = 1e30;
+    for( int i = 0; i < reps; ++i )
+    {
+        double t = bench_time( f );
+        if( t < best )
+            best = t;
+    }
+    return best;
+}
+
+// 让编译器认为x被读取过，避免整段计算被优化掉
+template <class T>
+inline void bench_keep( const T& x )
+{
+    asm volatile( "" : : "r"( &x ) : "memory" );
+}
+
+// 命令行第i个参数，缺省为def
+inline long bench_arg( int argc, char** argv, int i, long def )
+{
+    return argc > i ? std::atol( argv[i] ) : def;
+}
+
+#endif //SEQUENCE_CONTAINERS_BENCH_H
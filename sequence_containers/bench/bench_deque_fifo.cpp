@@ -0,0 +1,71 @@
+//
+// deque当作队列的吞吐量：稳定状态的push_back + pop_front，与成批进出，对照std::deque
+// 用法：bench_deque_fifo [操作数，缺省50M]
+//
+
+#include "sequence_containers.h"
+#include "bench/bench.h"
+#include <deque>
+
+// 队列中保持depth个元素，每次push_back一个再pop_front一个
+template <class Queue>
+double steady( long ops, long depth )
+{
+    Queue q;
+    for( long i = 0; i < depth; ++i )
+        q.push_back( int( i ) );
+    return bench_best( 3, [&]
+    {
+        long sum = 0;
+        for( long i = 0; i < ops; ++i )
+        {
+            q.push_back( int( i ) );
+            sum += q.front();
+            q.pop_front();
+        }
+        bench_keep( sum );
+    } );
+}
+
+// 每次push_back batch个，再全部pop_front
+template <class Queue>
+double burst( long ops, long batch )
+{
+    Queue q;
+    return bench_best( 3, [&]
+    {
+        long sum = 0;
+        for( long done = 0; done < ops; done += batch )
+        {
+            for( long i = 0; i < batch; ++i )
+                q.push_back( int( i ) );
+            for( long i = 0; i < batch; ++i )
+            {
+                sum += q.front();
+                q.pop_front();
+            }
+        }
+        bench_keep( sum );
+    } );
+}
+
+int main( int argc, char** argv )
+{
+    const long ops = bench_arg( argc, argv, 1, 50000000 );
+    printf( "%-20s %12s %12s\n", "workload", "LYH Mops/s", "std Mops/s" );
+    const long depths[] = { 16, 4096 };
+    for( long d : depths )
+    {
+        double a = steady< deque<int> >( ops, d );
+        double b = steady< std::deque<int> >( ops, d );
+        printf( "steady depth %-7ld %12.0f %12.0f\n", d, ops / a / 1e6, ops / b / 1e6 );
+    }
+    const long batches[] = { 64, 100000 };
+    for( long n : batches )
+    {
+        double a = burst< deque<int> >( ops, n );
+        double b = burst< std::deque<int> >( ops, n );
+        printf( "burst %-14ld %12.0f %12.0f\n", n, ops / a / 1e6, ops / b / 1e6 );
+    }
+    return 0;
+}
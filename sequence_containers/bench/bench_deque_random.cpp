@@ -0,0 +1,79 @@
+//
+// deque迭代器的随机存取：operator[]、远距离的+=与迭代器相减、缓冲区内的小步+=
+// 缓冲区大小为2的幂(位移与遮罩)与非2的幂(除法)各测一次，对照std::deque
+// 用法：bench_deque_random [元素个数，缺省4M] [存取次数，缺省40M]
+//
+
+#include "sequence_containers.h"
+#include "bench/bench.h"
+#include <deque>
+#include <vector>
+
+// 12字节的元素，缺省缓冲区的元素个数不是2的幂
+struct triple
+{
+    int a, b, c;
+    triple( long x = 0 ) : a( int( x ) ), b( 0 ), c( 0 ) {}
+};
+inline long value_of( long x ) { return x; }
+inline long value_of( const triple& x ) { return x.a; }
+
+template <class D>
+void run( const char* name, long n, const std::vector<long>& idx )
+{
+    D d;
+    for( long i = 0; i < n; ++i )
+        d.push_back( i );
+    typename D::iterator b = d.begin();
+
+    double index = bench_best( 3, [&]
+    {
+        long s = 0;
+        for( long i : idx )
+            s += value_of( d[i] );
+        bench_keep( s );
+    } );
+    double jump = bench_best( 3, [&]
+    {
+        long s = 0;
+        typename D::iterator it = b;
+        for( long i : idx )
+        {
+            it += i - ( it - b );
+            s += value_of( *it );
+        }
+        bench_keep( s );
+    } );
+    // 每步前进或后退至多3个元素，绝大多数落在同一个缓冲区
+    double step = bench_best( 3, [&]
+    {
+        long s = 0;
+        typename D::iterator it = b + n / 2;
+        for( long i : idx )
+        {
+            it += i % 7 - 3;
+            s += value_of( *it );
+        }
+        bench_keep( s );
+    } );
+    printf( "%-22s %10.3f %10.3f %10.3f\n", name, index, jump, step );
+}
+
+int main( int argc, char** argv )
+{
+    const long n = bench_arg( argc, argv, 1, 4L << 20 );
+    const long accesses = bench_arg( argc, argv, 2, 40L << 20 );
+    std::vector<long> idx( static_cast<size_t>( accesses ) );
+    unsigned x = 1;
+    for( size_t i = 0; i < idx.size(); ++i )
+    {
+        x = x * 1103515245 + 12345;
+        idx[i] = long( ( x >> 4 ) % unsigned( n ) );
+    }
+    printf( "%-22s %10s %10s %10s\n", "deque", "d[i] s", "+= far s", "+= near s" );
+    run< deque<long> >( "long, 64/buf", n, idx );
+    run< deque<long, alloc, 48> >( "long, 48/buf", n, idx );
+    run< deque<triple> >( "12-byte, default buf", n, idx );
+    run< std::deque<long> >( "std::deque<long>", n, idx );
+    return 0;
+}
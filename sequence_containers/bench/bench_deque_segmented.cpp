@@ -0,0 +1,120 @@
+//
+// deque的分段算法：find、fill、copy(deque到deque)、accumulate
+// 分段版本(LYH::，每个缓冲区以原生指针执行)对照逐一++的一般走法，以及std::deque配上std的算法
+// 用法：bench_deque_segmented [元素个数，缺省4M] [重复次数，缺省20]
+//
+
+#include "sequence_containers.h"
+#include "bench/bench.h"
+#include <algorithm>
+#include <deque>
+#include <numeric>
+
+// 一般算法的走法：每次++都检查缓冲区尾端
+struct generic_loops
+{
+    template <class It, class V>
+    static It find( It first, It last, const V& value )
+    {
+        for( ; first != last; ++first )
+            if( *first == value )
+                break;
+        return first;
+    }
+    template <class It, class V>
+    static void fill( It first, It last, const V& value )
+    {
+        for( ; first != last; ++first )
+            *first = value;
+    }
+    template <class InputIt, class OutputIt>
+    static OutputIt copy( InputIt first, InputIt last, OutputIt result )
+    {
+        for( ; first != last; ++first, ++result )
+            *result = *first;
+        return result;
+    }
+    template <class It, class V>
+    static V accumulate( It first, It last, V init )
+    {
+        for( ; first != last; ++first )
+            init = init + *first;
+        return init;
+    }
+};
+
+struct segmented_algorithms
+{
+    template <class It, class V>
+    static It find( It first, It last, const V& value ) { return LYH::find( first, last, value ); }
+    template <class It, class V>
+    static void fill( It first, It last, const V& value ) { LYH::fill( first, last, value ); }
+    template <class InputIt, class OutputIt>
+    static OutputIt copy( InputIt first, InputIt last, OutputIt result ) { return LYH::copy( first, last, result ); }
+    template <class It, class V>
+    static V accumulate( It first, It last, V init ) { return LYH::accumulate( first, last, init ); }
+};
+
+struct std_algorithms
+{
+    template <class It, class V>
+    static It find( It first, It last, const V& value ) { return std::find( first, last, value ); }
+    template <class It, class V>
+    static void fill( It first, It last, const V& value ) { std::fill( first, last, value ); }
+    template <class InputIt, class OutputIt>
+    static OutputIt copy( InputIt first, InputIt last, OutputIt result ) { return std::copy( first, last, result ); }
+    template <class It, class V>
+    static V accumulate( It first, It last, V init ) { return std::accumulate( first, last, init ); }
+};
+
+// 区间的头尾都不在缓冲区的边界上
+template <class D, class A>
+void run( const char* name, long n, int reps )
+{
+    typedef typename D::value_type T;
+    D src, dst;
+    for( long i = 0; i < n + 10; ++i )
+    {
+        src.push_back( T( i % 1000 ) );
+        dst.push_back( T( 0 ) );
+    }
+    for( int i = 0; i < 3; ++i )
+        src.pop_front();
+    for( int i = 0; i < 7; ++i )
+        dst.pop_front();
+
+    double find = bench_best( reps, [&]
+    {
+        bench_keep( A::find( src.begin(), src.end(), T( 5000 ) ) == src.end() );
+    } );
+    double fill = bench_best( reps, [&]
+    {
+        A::fill( dst.begin(), dst.end(), T( 7 ) );
+        bench_keep( dst.back() );
+    } );
+    double copy = bench_best( reps, [&]
+    {
+        A::copy( src.begin(), src.end(), dst.begin() );
+        bench_keep( dst.back() );
+    } );
+    double sum = bench_best( reps, [&]
+    {
+        bench_keep( A::accumulate( src.begin(), src.end(), 0L ) );
+    } );
+    printf( "%-26s %9.1f %9.1f %9.1f %9.1f\n", name,
+            find * 1e6, fill * 1e6, copy * 1e6, sum * 1e6 );
+}
+
+int main( int argc, char** argv )
+{
+    const long n = bench_arg( argc, argv, 1, 4L << 20 );
+    const int reps = int( bench_arg( argc, argv, 2, 20 ) );
+    printf( "%-26s %9s %9s %9s %9s\n", "us", "find", "fill", "copy", "accum" );
+    run< deque<int>, segmented_algorithms >( "int, segmented", n, reps );
+    run< deque<int>, generic_loops >( "int, generic", n, reps );
+    run< std::deque<int>, std_algorithms >( "int, std::deque", n, reps );
+    run< deque<long, alloc, 48>, segmented_algorithms >( "long 48/buf, segmented", n, reps );
+    run< deque<long, alloc, 48>, generic_loops >( "long 48/buf, generic", n, reps );
+    run< std::deque<long>, std_algorithms >( "long, std::deque", n, reps );
+    return 0;
+}
@@ -0,0 +1,81 @@
+//
+// find、equal、lexicographical_compare走memchr/memcmp与逐个元素的循环对照
+// 循环一栏以__false_type强制走一般版本
+// 用法：bench_find_equal [元素个数，缺省16M] [重复次数，缺省50]
+//
+
+#include "sequence_containers.h"
+#include "bench/bench.h"
+
+int main( int argc, char** argv )
+{
+    const long n = bench_arg( argc, argv, 1, 1L << 24 );
+    const long reps = bench_arg( argc, argv, 2, 50 );
+
+    // 要找的值不在序列中，每次都走完整个序列
+    vector<char> c( size_t( n ), 'a' );
+    vector<int> a( size_t( n / 4 ), 7 ), b( size_t( n / 4 ), 7 );
+    vector<unsigned char> u1( size_t( n ), 200 ), u2( size_t( n ), 200 );
+    deque<char> d( size_t( n ), 'a' );
+    // vector的迭代器即原生指针
+    char* cf = c.begin();
+    char* cl = c.end();
+    int* af = a.begin();
+    int* al = a.end();
+    int* bf = b.begin();
+    unsigned char* u1f = u1.begin();
+    unsigned char* u1l = u1.end();
+    unsigned char* u2f = u2.begin();
+    unsigned char* u2l = u2.end();
+
+    printf( "%-32s %12s %12s\n", "workload", "dispatch s", "loop s" );
+    double x = bench_best( 3, [&]
+    {
+        for( long r = 0; r < reps; ++r )
+            bench_keep( LYH::find( cf, cl, 'z' ) );
+    } );
+    double y = bench_best( 3, [&]
+    {
+        for( long r = 0; r < reps; ++r )
+            bench_keep( LYH::__find( cf, cl, 'z', __false_type() ) );
+    } );
+    printf( "%-32s %12.3f %12.3f\n", "find char", x, y );
+
+    x = bench_best( 3, [&]
+    {
+        for( long r = 0; r < reps; ++r )
+            bench_keep( LYH::equal( af, al, bf ) );
+    } );
+    y = bench_best( 3, [&]
+    {
+        for( long r = 0; r < reps; ++r )
+            bench_keep( LYH::__equal( af, al, bf, __false_type() ) );
+    } );
+    printf( "%-32s %12.3f %12.3f\n", "equal int", x, y );
+
+    x = bench_best( 3, [&]
+    {
+        for( long r = 0; r < reps; ++r )
+            bench_keep( LYH::lexicographical_compare( u1f, u1l, u2f, u2l ) );
+    } );
+    y = bench_best( 3, [&]
+    {
+        for( long r = 0; r < reps; ++r )
+            bench_keep( LYH::__lexicographical_compare( u1f, u1l, u2f, u2l, __false_type() ) );
+    } );
+    printf( "%-32s %12.3f %12.3f\n", "lexicographical_compare uchar", x, y );
+
+    // deque没有强制走一般版本的入口，循环一栏为std::find逐个元素走访
+    x = bench_best( 3, [&]
+    {
+        for( long r = 0; r < reps; ++r )
+            bench_keep( LYH::find( d.begin(), d.end(), 'z' ) );
+    } );
+    y = bench_best( 3, [&]
+    {
+        for( long r = 0; r < reps; ++r )
+            bench_keep( std::find( d.begin(), d.end(), 'z' ) );
+    } );
+    printf( "%-32s %12.3f %12.3f\n", "deque<char> find", x, y );
+    return 0;
+}
@@ -0,0 +1,39 @@
+//
+// 链表预取距离k的效果：节点在内存中随机散布时，for_each、remove、unique的走访时间
+// 用法：bench_list_prefetch [节点数，缺省4M]
+//
+
+#include "sequence_containers.h"
+#include "bench/bench.h"
+#include <random>
+
+// 依随机键排序一次，节点的链接次序便与配置次序无关，走访时每一步都可能cache miss
+struct by_hash
+{
+    bool operator()( int x, int y ) const { return unsigned( x ) * 2654435761u < unsigned( y ) * 2654435761u; }
+};
+
+int main( int argc, char** argv )
+{
+    const long n = bench_arg( argc, argv, 1, 4000000 );
+    const size_t ks[] = { 0, 2, 4, 8, 16 };
+
+    list<int> l;
+    for( long i = 0; i < n; ++i )
+        l.push_back( int( i ) );
+    l.sort( by_hash() );
+
+    printf( "%-6s %12s %12s %12s\n", "k", "for_each", "remove", "unique" );
+    for( size_t k : ks )
+    {
+        set_list_prefetch_distance( k );
+        long sum = 0;
+        double fe = bench_best( 3, [&]{ for_each( l.begin(), l.end(), [&]( int x ){ sum += x; } ); } );
+        // 值都不小于0，remove(-1)与unique都只走访不移除，每次的输入相同
+        double rm = bench_best( 3, [&]{ l.remove( -1 ); } );
+        double un = bench_best( 3, [&]{ l.unique(); } );
+        bench_keep( sum );
+        printf( "%-6zu %12.3f %12.3f %12.3f\n", k, fe, rm, un );
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+//
+// list::sort的扩展性：循序版本，与1、2、4...N个工作线程的list::sort(pool)
+// 用法：bench_list_sort [最大节点数，缺省10M] [最大工作线程数，缺省为硬件线程数]
+//
+
+#include "sequence_containers.h"
+#include "bench/bench.h"
+#include <random>
+#include <thread>
+
+// 依目前的节点次序重新填入随机值后排序，只计排序的时间，取reps次中最短的
+template <class Sort>
+static double time_sort( list<int>& l, int reps, Sort sort )
+{
+    double best = 1e30;
+    for( int r = 0; r < reps; ++r )
+    {
+        std::mt19937 gen( 1 );
+        for( list<int>::iterator it = l.begin(); it != l.end(); ++it )
+            *it = int( gen() );
+        double t = bench_time( sort );
+        if( t < best )
+            best = t;
+    }
+    return best;
+}
+
+int main( int argc, char** argv )
+{
+    const long max_nodes = bench_arg( argc, argv, 1, 10000000 );
+    long hw = long( std::thread::hardware_concurrency() );
+    const long max_workers = bench_arg( argc, argv, 2, hw > 0 ? hw : 1 );
+    const long sizes[] = { 1000000, 10000000, 50000000 };
+    printf( "hardware threads: %ld\n", hw );
+    printf( "%-10s %-8s %10s %8s\n", "nodes", "workers", "seconds", "speedup" );
+
+    for( long n : sizes )
+    {
+        if( n > max_nodes )
+            break;
+        list<int> l;
+        for( long i = 0; i < n; ++i )
+            l.push_back( 0 );
+        double serial = time_sort( l, 2, [&]{ l.sort(); } );
+        printf( "%-10ld %-8s %10.3f %8.2f\n", n, "serial", serial, 1.0 );
+        for( long w = 1; ; w *= 2 )
+        {
+            if( w > max_workers )
+                w = max_workers;
+            LYH::thread_pool pool( static_cast<size_t>( w ) );
+            double t = time_sort( l, 2, [&]{ l.sort( pool ); } );
+            printf( "%-10ld %-8ld %10.3f %8.2f\n", n, w, t, serial / t );
+            if( w == max_workers )
+                break;
+        }
+    }
+    return 0;
+}
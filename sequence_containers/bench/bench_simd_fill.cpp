@@ -0,0 +1,61 @@
+//
+// SIMD填充、复制核心的吞吐量：逐元素回圈、标量核心、各SIMD核心与LYH::fill/copy的分派结果
+// 用法：bench_simd_fill [总字节数，缺省4 GiB]
+//
+
+#include "sequence_containers.h"
+#include "bench/bench.h"
+
+// 元素回圈，禁止向量化，作为逐元素赋值的基准
+__attribute__((optimize("no-tree-vectorize")))
+static void fill_loop( int* first, size_t n, int x )
+{
+    for( size_t i = 0; i < n; ++i )
+        first[i] = x;
+}
+
+int main( int argc, char** argv )
+{
+    const size_t total = size_t( bench_arg( argc, argv, 1, 4L << 30 ) );
+    const size_t sizes[] = { 4 << 10, 256 << 10, 64 << 20 };
+    printf( "kernel selected: %s\n", LYH::__simd_dispatch().name );
+    printf( "%-10s %-18s %10s\n", "bytes", "variant", "GB/s" );
+
+    for( size_t bytes : sizes )
+    {
+        size_t n = bytes / sizeof(int);
+        size_t reps = total / bytes;
+        int* dst = static_cast<int*>( aligned_alloc( 64, bytes ) );
+        int* src = static_cast<int*>( aligned_alloc( 64, bytes ) );
+        for( size_t i = 0; i < n; ++i )
+            src[i] = int( i );
+        unsigned char pattern[64];
+        for( size_t i = 0; i < 64; i += sizeof(int) )
+            memcpy( pattern + i, &reps, sizeof(int) );
+
+        auto report = [&]( const char* name, double t )
+        {
+            printf( "%-10zu %-18s %10.2f\n", bytes, name, double( bytes ) * reps / t / 1e9 );
+        };
+        report( "fill loop", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { fill_loop( dst, n, int( r ) ); bench_keep( dst[0] ); } } ) );
+        report( "fill scalar", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { LYH::__fill_bytes_scalar( dst, bytes, pattern ); bench_keep( dst[0] ); } } ) );
+#ifdef __LYH_SIMD_X86
+        if( __builtin_cpu_supports( "avx2" ) )
+            report( "fill avx2", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { LYH::__fill_bytes_avx2( dst, bytes, pattern ); bench_keep( dst[0] ); } } ) );
+        if( __builtin_cpu_supports( "avx512f" ) )
+            report( "fill avx512", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { LYH::__fill_bytes_avx512( dst, bytes, pattern ); bench_keep( dst[0] ); } } ) );
+#endif
+        report( "LYH::fill", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { LYH::fill( dst, dst + n, int( r ) + 1 ); bench_keep( dst[0] ); } } ) );
+        report( "copy scalar", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { LYH::__copy_bytes_scalar( dst, src, bytes ); bench_keep( dst[0] ); } } ) );
+#ifdef __LYH_SIMD_X86
+        if( __builtin_cpu_supports( "avx2" ) )
+            report( "copy avx2", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { LYH::__copy_bytes_avx2( dst, src, bytes ); bench_keep( dst[0] ); } } ) );
+        if( __builtin_cpu_supports( "avx512f" ) )
+            report( "copy avx512", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { LYH::__copy_bytes_avx512( dst, src, bytes ); bench_keep( dst[0] ); } } ) );
+#endif
+        report( "LYH::copy", bench_best( 3, [&]{ for( size_t r = 0; r < reps; ++r ) { LYH::copy( src, src + n, dst ); bench_keep( dst[0] ); } } ) );
+        free( dst );
+        free( src );
+    }
+    return 0;
+}
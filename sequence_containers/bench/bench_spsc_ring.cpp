@@ -0,0 +1,90 @@
+//
+// spsc_ring的吞吐量：一个生产者线程与一个消费者线程，逐个与成批的push/pop
+// 用法：bench_spsc_ring [消息数，缺省100M] [容量，缺省65536]
+// 单核机器上两个线程轮流占用同一个核，数字主要反映切换的代价
+//
+
+#include "concurrent_containers.h"
+#include "bench/bench.h"
+#include <thread>
+
+typedef spsc_ring<long> ring;
+
+// 逐个push与pop，满了或空了就重试
+static double run_single( ring& q, long msgs )
+{
+    return bench_time( [&]
+    {
+        std::thread producer( [&]
+        {
+            for( long i = 0; i < msgs; ++i )
+                while( !q.push( i ) )
+                    std::this_thread::yield();
+        } );
+        long sum = 0, x;
+        for( long i = 0; i < msgs; ++i )
+        {
+            while( !q.pop( x ) )
+                std::this_thread::yield();
+            sum += x;
+        }
+        producer.join();
+        if( sum != msgs * ( msgs - 1 ) / 2 )
+            std::abort();
+    } );
+}
+
+// 每次push、pop至多batch个
+static double run_batched( ring& q, long msgs, long batch )
+{
+    return bench_time( [&]
+    {
+        std::thread producer( [&]
+        {
+            long buf[4096];
+            for( long i = 0; i < msgs; )
+            {
+                long n = std::min( batch, msgs - i );
+                for( long k = 0; k < n; ++k )
+                    buf[k] = i + k;
+                long done = 0;
+                while( done < n )
+                {
+                    long m = long( q.push( buf + done, size_t( n - done ) ) );
+                    if( m == 0 )
+                        std::this_thread::yield();
+                    done += m;
+                }
+                i += n;
+            }
+        } );
+        long buf[4096];
+        long sum = 0;
+        for( long got = 0; got < msgs; )
+        {
+            long m = long( q.pop( buf, size_t( std::min( batch, msgs - got ) ) ) );
+            if( m == 0 )
+                std::this_thread::yield();
+            for( long k = 0; k < m; ++k )
+                sum += buf[k];
+            got += m;
+        }
+        producer.join();
+        if( sum != msgs * ( msgs - 1 ) / 2 )
+            std::abort();
+    } );
+}
+
+int main( int argc, char** argv )
+{
+    const long msgs = bench_arg( argc, argv, 1, 100000000 );
+    const long cap = bench_arg( argc, argv, 2, 65536 );
+    printf( "hardware threads: %u\n", std::thread::hardware_concurrency() );
+    printf( "%-12s %14s\n", "batch", "M msgs/s" );
+    ring q( static_cast<size_t>( cap ) );
+    printf( "%-12d %14.1f\n", 1, msgs / run_single( q, msgs ) / 1e6 );
+    const long batches[] = { 16, 256, 4096 };
+    for( long b : batches )
+        printf( "%-12ld %14.1f\n", b, msgs / run_batched( q, msgs, b ) / 1e6 );
+    return 0;
+}
@@ -0,0 +1,639 @@
+//
+// 可以跨线程共用的序列容器
+//
+
+#ifndef SEQUENCE_CONTAINERS_CONCURRENT_CONTAINERS_H
+#define SEQUENCE_CONTAINERS_CONCURRENT_CONTAINERS_H
+
+#include <atomic>
+#include <exception>
+#include <thread>
+#include "sequence_containers.h"
+
+// cache line的大小，分属不同线程的成员以此隔开，避免伪共享(false sharing)
+#ifndef LYH_CACHE_LINE_SIZE
+# define LYH_CACHE_LINE_SIZE 64
+#endif
+
+// 单生产者、单消费者的无锁环形队列
+// 存储与deque相同：一个map指向若干缓冲区，缓冲区大小由BufSiz与BufPolicy决定；
+// 生产者与消费者各持一个__deque_iterator走访缓冲区，走到map尾端时绕回map开头
+// 所有缓冲区在构造时一次配置好，之后随着环形的绕回重复使用，执行期不再经过配置器，
+// 因此Alloc不必是线程安全的配置器
+// 只有一个线程可以调用push系列，只有一个线程可以调用pop系列
+template <class T, class Alloc = alloc, size_t BufSiz = 0, class BufPolicy = deque_buffer_policy<> >
+class spsc_ring
+{
+public:
+    typedef T                   value_type;
+    typedef value_type*         pointer;
+    typedef size_t              size_type;
+    typedef __deque_iterator<T, T&, T*, __deque_buf_elems<T, BufSiz, BufPolicy>::value,
+                             BufPolicy::compact_iterator> iterator;
+
+protected:
+    typedef pointer* map_pointer;
+    typedef simple_alloc<value_type, typename __deque_buf_alloc<Alloc, BufPolicy>::type> data_allocator;
+    typedef simple_alloc<pointer, Alloc> map_allocator;
+
+    static constexpr size_type buffer_size() { return iterator::buffer_size(); }
+
+    // 生产者独占：写入位置与已写入的元素总数，以及上次读到的head
+    alignas( LYH_CACHE_LINE_SIZE ) std::atomic<size_type> tail;
+    iterator wpos;
+    size_type head_cache;
+
+    // 消费者独占：读出位置与已读出的元素总数，以及上次读到的tail
+    alignas( LYH_CACHE_LINE_SIZE ) std::atomic<size_type> head;
+    iterator rpos;
+    size_type tail_cache;
+
+    // 两者共用，构造后不再改变
+    alignas( LYH_CACHE_LINE_SIZE ) map_pointer map;
+    size_type map_size;
+    size_type cap;
+
+    // 迭代器走到缓冲区尾端时切换到下一个缓冲区，最后一个缓冲区之后绕回第一个
+    void next_node( iterator& it ) const
+    {
+        it.set_node( it.node + 1 == map + map_size ? map : it.node + 1 );
+        it.cur = it.buf_first();
+    }
+
+public:
+    // 容量至少为capacity，向上取整为缓冲区大小的倍数，至少两个缓冲区
+    explicit spsc_ring( size_type capacity )
+    : tail(0), head_cache(0), head(0), tail_cache(0), map(0), map_size(0), cap(0)
+    {
+        map_size = ( capacity + buffer_size() - 1 ) / buffer_size();
+        if( map_size < 2 )
+            map_size = 2;
+        cap = map_size * buffer_size();
+        map = map_allocator::allocate( map_size );
+        map_pointer cur = map;
+        try
+        {
+            for( ; cur != map + map_size; ++cur )
+                *cur = data_allocator::allocate( buffer_size() );
+        }
+        catch(...)
+        {
+            for( map_pointer n = map; n != cur; ++n )
+                data_allocator::deallocate( *n, buffer_size() );
+            map_allocator::deallocate( map, map_size );
+            throw;
+        }
+        wpos.set_node( map );
+        wpos.cur = wpos.buf_first();
+        rpos = wpos;
+    }
+    // 析构时两端都必须已经停止
+    ~spsc_ring()
+    {
+        size_type n = tail.load( std::memory_order_acquire ) - head.load( std::memory_order_relaxed );
+        for( ; n > 0; --n )
+        {
+            destroy( rpos.cur );
+            if( ++rpos.cur == rpos.buf_last() )
+                next_node( rpos );
+        }
+        for( map_pointer cur = map; cur != map + map_size; ++cur )
+            data_allocator::deallocate( *cur, buffer_size() );
+        map_allocator::deallocate( map, map_size );
+    }
+
+    size_type capacity() const { return cap; }
+    // 元素个数，另一端同时在操作时只是近似值
+    size_type size() const
+    {
+        return tail.load( std::memory_order_acquire ) - head.load( std::memory_order_acquire );
+    }
+    bool empty() const { return size() == 0; }
+
+    // 生产者：放入一个元素，队列已满时传回false
+    bool push( const value_type& x )
+    {
+        size_type t = tail.load( std::memory_order_relaxed );
+        if( t - head_cache == cap )
+        {
+            head_cache = head.load( std::memory_order_acquire );
+            if( t - head_cache == cap )
+                return false;
+        }
+        construct( wpos.cur, x );
+        if( ++wpos.cur == wpos.buf_last() )
+            next_node( wpos );
+        tail.store( t + 1, std::memory_order_release );
+        return true;
+    }
+    // 生产者：放入[first, first + n)中尽可能多的元素，传回放入的个数
+    // 按缓冲区分段复制，整批只发布一次
+    // 以wpos的副本走访，全部复制成功后才与tail一起更新；复制中途抛出异常时
+    // 析构前面几段已构造的元素，wpos与tail都不变(commit or rollback)
+    size_type push( const value_type* first, size_type n )
+    {
+        size_type t = tail.load( std::memory_order_relaxed );
+        if( cap - ( t - head_cache ) < n )
+            head_cache = head.load( std::memory_order_acquire );
+        size_type room = cap - ( t - head_cache );
+        if( n > room )
+            n = room;
+        iterator w = wpos;
+        size_type left = n;
+        try
+        {
+            while( left > 0 )
+            {
+                size_type len = std::min( left, size_type( w.buf_last() - w.cur ) );
+                LYH::uninitialized_copy( first, first + len, w.cur );
+                first += len;
+                left -= len;
+                w.cur += len;
+                if( w.cur == w.buf_last() )
+                    next_node( w );
+            }
+        }
+        catch(...)
+        {
+            for( iterator d = wpos; left < n; ++left )
+            {
+                destroy( d.cur );
+                if( ++d.cur == d.buf_last() )
+                    next_node( d );
+            }
+            throw;
+        }
+        if( n > 0 )
+        {
+            wpos = w;
+            tail.store( t + n, std::memory_order_release );
+        }
+        return n;
+    }
+
+    // 消费者：取出一个元素，队列为空时传回false
+    bool pop( value_type& x )
+    {
+        size_type h = head.load( std::memory_order_relaxed );
+        if( h == tail_cache )
+        {
+            tail_cache = tail.load( std::memory_order_acquire );
+            if( h == tail_cache )
+                return false;
+        }
+        x = *rpos.cur;
+        destroy( rpos.cur );
+        if( ++rpos.cur == rpos.buf_last() )
+            next_node( rpos );
+        head.store( h + 1, std::memory_order_release );
+        return true;
+    }
+    // 消费者：取出至多n个元素放到result，传回取出的个数
+    size_type pop( value_type* result, size_type n )
+    {
+        size_type h = head.load( std::memory_order_relaxed );
+        if( tail_cache - h < n )
+            tail_cache = tail.load( std::memory_order_acquire );
+        if( n > tail_cache - h )
+            n = tail_cache - h;
+        for( size_type left = n; left > 0; )
+        {
+            size_type len = std::min( left, size_type( rpos.buf_last() - rpos.cur ) );
+            LYH::copy( (const value_type*) rpos.cur, (const value_type*) rpos.cur + len, result );
+            destroy( rpos.cur, rpos.cur + len );
+            result += len;
+            left -= len;
+            rpos.cur += len;
+            if( rpos.cur == rpos.buf_last() )
+                next_node( rpos );
+        }
+        if( n > 0 )
+            head.store( h + n, std::memory_order_release );
+        return n;
+    }
+
+private:
+    spsc_ring( const spsc_ring& );
+    spsc_ring& operator=( const spsc_ring& );
+};
+
+// 工作窃取双端队列(Chase-Lev)
+// 拥有者在底端push、pop，其他线程(窃取者)从顶端steal，都不加锁
+// 存储与deque相同：map指向若干缓冲区，以环形的方式使用；
+// 缓冲区大小取为2的幂，下标i位于map[(i / 缓冲区大小) % map大小]，以位移与遮罩计算
+// 空间不足时由拥有者重整map：换一个两倍大的map，旧的缓冲区原封不动地放进新map，
+// 元素本身不移动，只补上新的缓冲区；窃取者手上的旧map仍指向同样的缓冲区，
+// 因此旧map只需保留到析构时再释放
+// 元素以std::atomic<T>存放，T必须是trivially copyable(通常是任务的指针)
+// 只有拥有者会配置空间，但配置器是全行程共用的，缺省使用加锁的threaded_alloc
+template <class T, class Alloc = threaded_alloc, size_t BufSiz = 0, class BufPolicy = deque_buffer_policy<> >
+class work_stealing_deque
+{
+public:
+    typedef T                   value_type;
+    typedef size_t              size_type;
+
+protected:
+    typedef std::atomic<T>      slot_type;
+    typedef slot_type*          buffer_pointer;
+
+    // 缓冲区大小：deque的缓冲区大小向下取为2的幂
+    static const size_type buf_shift = __log2_floor<__deque_buf_elems<slot_type, BufSiz, BufPolicy>::value>::value;
+    static const size_type buf_mask = ( size_type(1) << buf_shift ) - 1;
+
+    // map连同它的大小一起替换，retired串起已被替换的旧map
+    struct map_type
+    {
+        size_type mask;             // map大小减一，map大小为2的幂
+        buffer_pointer* nodes;
+        map_type* retired;
+    };
+
+    typedef simple_alloc<slot_type, typename __deque_buf_alloc<Alloc, BufPolicy>::type> data_allocator;
+    typedef simple_alloc<buffer_pointer, Alloc> node_allocator;
+    typedef simple_alloc<map_type, Alloc> map_allocator;
+
+    alignas( LYH_CACHE_LINE_SIZE ) std::atomic<ptrdiff_t> top;      // 窃取者竞争
+    alignas( LYH_CACHE_LINE_SIZE ) std::atomic<ptrdiff_t> bottom;   // 只有拥有者写入
+    std::atomic<map_type*> array;
+
+    static slot_type& slot( map_type* a, ptrdiff_t i )
+    {
+        return a->nodes[ ( size_type( i ) >> buf_shift ) & a->mask ][ size_type( i ) & buf_mask ];
+    }
+    static map_type* new_map( size_type map_size )
+    {
+        map_type* a = map_allocator::allocate();
+        a->mask = map_size - 1;
+        try
+        {
+            a->nodes = node_allocator::allocate( map_size );
+        }
+        catch(...)
+        {
+            map_allocator::deallocate( a );
+            throw;
+        }
+        a->retired = 0;
+        return a;
+    }
+    static void delete_map( map_type* a )
+    {
+        node_allocator::deallocate( a->nodes, a->mask + 1 );
+        map_allocator::deallocate( a );
+    }
+
+    // 重整map：[t, b)所在的缓冲区依下标放进两倍大的新map，其余位置配置新缓冲区
+    map_type* grow( map_type* a, ptrdiff_t t )
+    {
+        size_type old_size = a->mask + 1;
+        map_type* na = new_map( 2 * old_size );
+        size_type first_seg = size_type( t ) >> buf_shift;
+        std::fill( na->nodes, na->nodes + 2 * old_size, buffer_pointer(0) );
+        for( size_type k = first_seg; k != first_seg + old_size; ++k )
+            na->nodes[ k & na->mask ] = a->nodes[ k & a->mask ];
+        size_type k = 0;
+        try
+        {
+            for( ; k != 2 * old_size; ++k )
+                if( na->nodes[k] == 0 )
+                    na->nodes[k] = data_allocator::allocate( buf_mask + 1 );
+        }
+        catch(...)
+        {
+            // 只释放新配置的缓冲区，旧map保持原样
+            for( size_type j = 0; j != k; ++j )
+                if( ( ( j - first_seg ) & na->mask ) >= old_size )
+                    data_allocator::deallocate( na->nodes[j], buf_mask + 1 );
+            delete_map( na );
+            throw;
+        }
+        na->retired = a;
+        array.store( na, std::memory_order_release );
+        return na;
+    }
+
+public:
+    // 初始为map_size个缓冲区，map_size向上取为2的幂，至少为1
+    // 配置缓冲区中途失败时，释放已配置的缓冲区与map
+    explicit work_stealing_deque( size_type map_size = 4 )
+    : top(0), bottom(0), array(0)
+    {
+        size_type n = 1;
+        while( n < map_size )
+            n <<= 1;
+        map_type* a = new_map( n );
+        size_type k = 0;
+        try
+        {
+            for( ; k != n; ++k )
+                a->nodes[k] = data_allocator::allocate( buf_mask + 1 );
+        }
+        catch(...)
+        {
+            for( size_type j = 0; j != k; ++j )
+                data_allocator::deallocate( a->nodes[j], buf_mask + 1 );
+            delete_map( a );
+            throw;
+        }
+        array.store( a, std::memory_order_relaxed );
+    }
+    // 析构时不能再有窃取者
+    ~work_stealing_deque()
+    {
+        map_type* a = array.load( std::memory_order_relaxed );
+        for( size_type k = 0; k != a->mask + 1; ++k )
+            data_allocator::deallocate( a->nodes[k], buf_mask + 1 );
+        while( a != 0 )
+        {
+            map_type* next = a->retired;
+            delete_map( a );
+            a = next;
+        }
+    }
+
+    // 元素个数，其他线程同时在操作时只是近似值
+    size_type size() const
+    {
+        ptrdiff_t n = bottom.load( std::memory_order_relaxed ) - top.load( std::memory_order_relaxed );
+        return n > 0 ? size_type( n ) : 0;
+    }
+    bool empty() const { return size() == 0; }
+
+    // 拥有者：从底端放入
+    // 底端将要写入的缓冲区与顶端所在的缓冲区在map上撞在一起时，先重整map
+    void push( const value_type& x )
+    {
+        ptrdiff_t b = bottom.load( std::memory_order_relaxed );
+        ptrdiff_t t = top.load( std::memory_order_acquire );
+        map_type* a = array.load( std::memory_order_relaxed );
+        if( ( size_type( b ) >> buf_shift ) - ( size_type( t ) >> buf_shift ) > a->mask )
+            a = grow( a, t );
+        slot( a, b ).store( x, std::memory_order_relaxed );
+        bottom.store( b + 1, std::memory_order_release );
+    }
+
+    // 拥有者：从底端取出，队列为空时传回false
+    // 只剩一个元素时与窃取者竞争顶端
+    bool pop( value_type& x )
+    {
+        ptrdiff_t b = bottom.load( std::memory_order_relaxed ) - 1;
+        map_type* a = array.load( std::memory_order_relaxed );
+        bottom.exchange( b, std::memory_order_seq_cst );
+        ptrdiff_t t = top.load( std::memory_order_seq_cst );
+        if( t > b )
+        {
+            // 已经空了
+            bottom.store( b + 1, std::memory_order_relaxed );
+            return false;
+        }
+        x = slot( a, b ).load( std::memory_order_relaxed );
+        if( t == b )
+        {
+            // 最后一个元素，以CAS与窃取者竞争
+            bool won = top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+            bottom.store( b + 1, std::memory_order_relaxed );
+            return won;
+        }
+        return true;
+    }
+
+    // 窃取者：从顶端取出，队列为空或与其他线程竞争失败时传回false
+    bool steal( value_type& x )
+    {
+        ptrdiff_t t = top.load( std::memory_order_seq_cst );
+        ptrdiff_t b = bottom.load( std::memory_order_seq_cst );
+        if( t >= b )
+            return false;
+        map_type* a = array.load( std::memory_order_acquire );
+        value_type v = slot( a, t ).load( std::memory_order_relaxed );
+        if( !top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed ) )
+            return false;
+        x = v;
+        return true;
+    }
+
+private:
+    work_stealing_deque( const work_stealing_deque& );
+    work_stealing_deque& operator=( const work_stealing_deque& );
+};
+
+// 最高位1的位置，x不得为0
+inline size_t __highest_bit( size_t x )
+{
+#if defined( __GNUC__ )
+    return sizeof(unsigned long long) * 8 - 1 - __builtin_clzll( (unsigned long long) x );
+#else
+    size_t k = 0;
+    while( x >>= 1 )
+        ++k;
+    return k;
+#endif
+}
+
+// 可并发push_back的vector，元素地址永不改变
+// 空间分成大小依次加倍的若干段：第0段有B个元素，第s段有B << s个元素，
+// 下标i所在的段由i + B的最高位决定，段内偏移为i + B去掉最高位
+// 段表是固定大小的数组，段配置好之后不再搬动，因此扩充时不会使既有元素的指针失效
+// push_back以fetch_add取得下标，所在的段尚未配置时配置一段并以CAS装入，
+// 竞争失败的一方归还它配置的段
+// 每个位置有一个就绪旗标，元素构造完成后以release设立；push_back从不等待其他线程，
+// 某个push_back停住(例如线程被换出)不会拖住其他的push_back
+// size()是从0起连续就绪的元素个数，[0, size())之内的元素可以与push_back同时读取；
+// 前面还有元素在构造时，其后已就绪的元素不计入size()，可以先以ready(i)检查再读取
+// 元素构造或段的配置抛出异常时，该位置永远不会就绪，size()停在它之前，异常照常抛出
+template <class T, class Alloc = threaded_alloc>
+class concurrent_vector
+{
+public:
+    typedef T                   value_type;
+    typedef value_type*         pointer;
+    typedef value_type&         reference;
+    typedef const value_type&   const_reference;
+    typedef size_t              size_type;
+
+protected:
+    // 每段一次配置：前面放元素，后面接着每个元素一个字节的就绪旗标
+    typedef simple_alloc<char, Alloc> segment_allocator;
+    typedef std::atomic<unsigned char> flag_type;
+
+    // 第0段的大小取deque一个缓冲区的元素个数向下取为2的幂
+    static const size_type first_shift = __log2_floor<__deque_buf_elems<T, 0, deque_buffer_policy<> >::value>::value;
+    static const size_type first_size = size_type(1) << first_shift;
+    static const size_type max_segments = sizeof(size_type) * 8 - first_shift;
+
+    alignas( LYH_CACHE_LINE_SIZE ) std::atomic<size_type> reserved;         // 已分出的下标个数
+    alignas( LYH_CACHE_LINE_SIZE ) mutable std::atomic<size_type> prefix;   // 已知连续就绪的元素个数
+    alignas( LYH_CACHE_LINE_SIZE ) std::atomic<pointer> segments[max_segments];
+
+    static size_type segment_of( size_type i ) { return __highest_bit( i + first_size ) - first_shift; }
+    static size_type segment_size( size_type s ) { return first_size << s; }
+    static size_type segment_base( size_type s ) { return ( first_size << s ) - first_size; }
+    static size_type segment_bytes( size_type s ) { return segment_size( s ) * ( sizeof(value_type) + sizeof(flag_type) ); }
+    static flag_type* flags_of( pointer p, size_type s ) { return reinterpret_cast<flag_type*>( p + segment_size( s ) ); }
+
+    // 传回第s段，尚未配置时配置之，旗标全部清为未就绪
+    pointer segment( size_type s )
+    {
+        pointer p = segments[s].load( std::memory_order_acquire );
+        if( p == 0 )
+        {
+            pointer q = reinterpret_cast<pointer>( segment_allocator::allocate( segment_bytes( s ) ) );
+            flag_type* f = flags_of( q, s );
+            for( size_type k = 0; k != segment_size( s ); ++k )
+                new ((void*) ( f + k )) flag_type( 0 );
+            if( segments[s].compare_exchange_strong( p, q, std::memory_order_acq_rel, std::memory_order_acquire ) )
+                p = q;
+            else
+                segment_allocator::deallocate( reinterpret_cast<char*>( q ), segment_bytes( s ) );
+        }
+        return p;
+    }
+    pointer slot( size_type i ) const
+    {
+        size_type s = segment_of( i );
+        return segments[s].load( std::memory_order_acquire ) + ( i - segment_base( s ) );
+    }
+
+    // 从已知的前缀往后数出连续就绪的元素个数，并推进已知的前缀
+    size_type scan_prefix() const
+    {
+        size_type start = prefix.load( std::memory_order_acquire );
+        size_type r = reserved.load( std::memory_order_acquire );
+        size_type n = start;
+        while( n < r && ready( n ) )
+            ++n;
+        size_type cur = start;
+        while( cur < n && !prefix.compare_exchange_weak( cur, n, std::memory_order_acq_rel, std::memory_order_acquire ) )
+            ;
+        return cur > n ? cur : n;
+    }
+
+    // 在下标[first, first + n)上构造x的副本，跨段时分段处理，每构造一个就设立它的旗标
+    // 段的配置或构造抛出异常时，尚未构造的位置保持未就绪，异常直接抛出
+    void fill_construct( size_type first, size_type n, const value_type& x )
+    {
+        size_type last = first + n;
+        for( size_type s = segment_of( first ); s <= segment_of( last - 1 ); ++s )
+            segment( s );
+        for( size_type i = first; i != last; )
+        {
+            size_type s = segment_of( i );
+            size_type off = i - segment_base( s );
+            size_type len = std::min( last - i, segment_size( s ) - off );
+            pointer p = segments[s].load( std::memory_order_acquire ) + off;
+            flag_type* f = flags_of( p - off, s ) + off;
+            for( size_type k = 0; k != len; ++k )
+            {
+                construct( p + k, x );
+                f[k].store( 1, std::memory_order_release );
+            }
+            i += len;
+        }
+        // 只有接在已知前缀之后的才往后推进，其余的留给前面的元素或size()
+        if( prefix.load( std::memory_order_acquire ) == first )
+            scan_prefix();
+    }
+
+public:
+    concurrent_vector() : reserved(0), prefix(0)
+    {
+        for( size_type s = 0; s != max_segments; ++s )
+            segments[s].store( 0, std::memory_order_relaxed );
+    }
+    // 析构时不能再有其他线程在使用
+    ~concurrent_vector()
+    {
+        clear();
+        for( size_type s = 0; s != max_segments; ++s )
+        {
+            pointer p = segments[s].load( std::memory_order_relaxed );
+            if( p != 0 )
+                segment_allocator::deallocate( reinterpret_cast<char*>( p ), segment_bytes( s ) );
+        }
+    }
+
+    // 从0起连续就绪的元素个数
+    size_type size() const { return scan_prefix(); }
+    bool empty() const { return size() == 0; }
+    // 已配置的段可容纳的元素个数
+    size_type capacity() const
+    {
+        size_type s = 0;
+        while( s != max_segments && segments[s].load( std::memory_order_acquire ) != 0 )
+            ++s;
+        return segment_base( s );
+    }
+
+    // 下标i上的元素是否已构造完成，可以读取
+    bool ready( size_type i ) const
+    {
+        size_type s = segment_of( i );
+        pointer p = segments[s].load( std::memory_order_acquire );
+        return p != 0 && flags_of( p, s )[i - segment_base( s )].load( std::memory_order_acquire ) != 0;
+    }
+
+    // i < size()，或ready(i)，或是本线程push_back传回的下标
+    reference operator[]( size_type i ) { return *slot( i ); }
+    const_reference operator[]( size_type i ) const { return *slot( i ); }
+
+    // 放入一个元素，传回它的下标
+    size_type push_back( const value_type& x )
+    {
+        size_type i = reserved.fetch_add( 1, std::memory_order_relaxed );
+        fill_construct( i, 1, x );
+        return i;
+    }
+    // 放入n个x，下标连续，传回第一个的下标
+    size_type grow_by( size_type n, const value_type& x )
+    {
+        size_type i = reserved.fetch_add( n, std::memory_order_relaxed );
+        if( n != 0 )
+            fill_construct( i, n, x );
+        return i;
+    }
+    size_type grow_by( size_type n ) { return grow_by( n, value_type() ); }
+
+    // 预先配置足以容纳n个元素的段
+    void reserve( size_type n )
+    {
+        if( n == 0 )
+            return;
+        for( size_type s = 0, last = segment_of( n - 1 ); s <= last; ++s )
+            segment( s );
+    }
+
+    // 析构所有已就绪的元素并清除旗标，未就绪的位置跳过，保留已配置的段
+    // 不能与其他操作同时进行
+    void clear()
+    {
+        size_type n = reserved.load( std::memory_order_relaxed );
+        for( size_type i = 0; i < n; )
+        {
+            size_type s = segment_of( i );
+            size_type len = std::min( n - i, segment_size( s ) );
+            pointer p = segments[s].load( std::memory_order_relaxed );
+            if( p != 0 )
+            {
+                flag_type* f = flags_of( p, s );
+                for( size_type k = 0; k != len; ++k )
+                {
+                    if( f[k].load( std::memory_order_relaxed ) != 0 )
+                    {
+                        destroy( p + k );
+                        f[k].store( 0, std::memory_order_relaxed );
+                    }
+                }
+            }
+            i += len;
+        }
+        reserved.store( 0, std::memory_order_relaxed );
+        prefix.store( 0, std::memory_order_relaxed );
+    }
+
+private:
+    concurrent_vector( const concurrent_vector& );
+    concurrent_vector& operator=( const concurrent_vector& );
+};
+
+#endif //SEQUENCE_CONTAINERS_CONCURRENT_CONTAINERS_H
@@ -0,0 +1,159 @@
+//
+// 迭代器的型别与分类，容器与算法共用
+//
+
+#ifndef SEQUENCE_CONTAINERS_ITERATOR_TRAITS_H
+#define SEQUENCE_CONTAINERS_ITERATOR_TRAITS_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace LYH
+{
+    // 5个标记用的型别
+    // 直接沿用std的标记而不另外定义，容器的迭代器因此也能交给std的算法使用
+    // 继承关系的使用是为了去掉单纯的传递调用
+    typedef std::input_iterator_tag          input_iterator_tag;
+    typedef std::output_iterator_tag         output_iterator_tag;
+    typedef std::forward_iterator_tag        forward_iterator_tag;
+    typedef std::bidirectional_iterator_tag  bidirectional_iterator_tag;
+    typedef std::random_access_iterator_tag  random_access_iterator_tag;
+    // 元素在内存中连续存放的随机存取迭代器(原生指针、vector的迭代器)
+    // 算法据此可以改走memmove、memset、SIMD等以字节区间为单位的做法
+    // 派生自random_access_iterator_tag，只认得前5种标记的算法会把它当成随机存取迭代器
+    struct contiguous_iterator_tag : public random_access_iterator_tag {};
+
+    // 设计迭代器时，直接继承此结构，可保证符合STL架构
+    template <class Category, class T, class Distance = ptrdiff_t, class Pointer = T*, class Reference = T&>
+    struct iterator
+    {
+        typedef Category    iterator_category;
+        typedef T           value_type;
+        typedef Distance    difference_type;
+        typedef Pointer     pointer;
+        typedef Reference   reference;
+    };
+
+    // 特性萃取机，迭代器必须遵守约定，自行以内嵌型别定义
+    template <class I>      // 泛化版本，传入一个迭代器
+    struct iterator_traits
+    {
+        typedef typename I::iterator_category   iterator_category;  // 迭代器类型
+        typedef typename I::value_type          value_type;         // 迭代器所指之物的型别
+        typedef typename I::difference_type     difference_type;    // 两个迭代器间的距离
+        typedef typename I::pointer             pointer;            // 指向迭代器所指之物（指针）
+        typedef typename I::reference           reference;          // 迭代器所指之物(引用)
+    };
+
+    template <class T>      // 特化版本1，传入原生指针
+    struct iterator_traits<T*>
+    {
+        typedef contiguous_iterator_tag iterator_category;
+        typedef T                       value_type;
+        typedef ptrdiff_t               difference_type;
+        typedef T*                      pointer;
+        typedef T&                      reference;
+    };
+
+    template <class T>      // 特化版本2，传入const型原生指针，value_type去掉const，pointer与reference保留
+    struct iterator_traits<const T*>
+    {
+        typedef contiguous_iterator_tag iterator_category;
+        typedef T                       value_type;
+        typedef ptrdiff_t               difference_type;
+        typedef const T*                pointer;
+        typedef const T&                reference;
+    };
+
+    // 取得迭代器的类型(标记对象)与距离型别，供重载决议使用
+    template <class I>
+    inline typename iterator_traits<I>::iterator_category
+    iterator_category( const I& )
+    {
+        typedef typename iterator_traits<I>::iterator_category category;
+        return category();
+    }
+
+    template <class I>
+    inline typename iterator_traits<I>::difference_type*
+    distance_type( const I& )
+    {
+        return static_cast<typename iterator_traits<I>::difference_type*>(0);
+    }
+
+    // 编译期判断迭代器的类型
+    template <class I>
+    struct __is_random_access_iterator
+        : std::is_convertible<typename iterator_traits<I>::iterator_category, random_access_iterator_tag> {};
+    template <class I>
+    struct __is_contiguous_iterator
+        : std::is_convertible<typename iterator_traits<I>::iterator_category, contiguous_iterator_tag> {};
+
+    // distance：单向逐一计数，随机存取直接相减
+    // 标记是std的型别，分派时以LYH::限定，以免ADL找到std内部同名的__distance、__advance
+    template <class InputIterator>
+    inline typename iterator_traits<InputIterator>::difference_type
+    __distance( InputIterator first, InputIterator last, input_iterator_tag )
+    {
+        typename iterator_traits<InputIterator>::difference_type n = 0;
+        for( ; first != last; ++first )
+            ++n;
+        return n;
+    }
+    template <class RandomAccessIterator>
+    inline typename iterator_traits<RandomAccessIterator>::difference_type
+    __distance( RandomAccessIterator first, RandomAccessIterator last, random_access_iterator_tag )
+    {
+        return last - first;
+    }
+    template <class InputIterator>
+    inline typename iterator_traits<InputIterator>::difference_type
+    distance( InputIterator first, InputIterator last )
+    {
+        return LYH::__distance( first, last, iterator_category( first ) );
+    }
+
+    // advance：单向逐一前进，双向可以后退，随机存取一步到位
+    // 单纯的传递调用(forward_iterator_tag)不必写，不匹配时自动向上层（基类）转换
+    template <class InputIterator, class Distance>
+    inline void __advance( InputIterator& i, Distance n, input_iterator_tag )
+    {
+        while( n-- ) ++i;
+    }
+    template <class BidirectionalIterator, class Distance>
+    inline void __advance( BidirectionalIterator& i, Distance n, bidirectional_iterator_tag )
+    {
+        if( n >= 0 )
+            while( n-- ) ++i;
+        else
+            while( n++ ) --i;
+    }
+    template <class RandomAccessIterator, class Distance>
+    inline void __advance( RandomAccessIterator& i, Distance n, random_access_iterator_tag )
+    {
+        i += n;
+    }
+    // 上层接口
+    // STL算法命名规则：以算法能接受之最低阶迭代器类型命名
+    template <class InputIterator, class Distance>
+    inline void advance( InputIterator& i, Distance n )
+    {
+        LYH::__advance( i, n, iterator_category( i ) );
+    }
+
+    template <class InputIterator>
+    inline InputIterator next( InputIterator i, typename iterator_traits<InputIterator>::difference_type n = 1 )
+    {
+        LYH::advance( i, n );
+        return i;
+    }
+    template <class BidirectionalIterator>
+    inline BidirectionalIterator prev( BidirectionalIterator i, typename iterator_traits<BidirectionalIterator>::difference_type n = 1 )
+    {
+        LYH::advance( i, -n );
+        return i;
+    }
+}
+
+#endif //SEQUENCE_CONTAINERS_ITERATOR_TRAITS_H
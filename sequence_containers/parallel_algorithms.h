@@ -0,0 +1,339 @@
+//
+// 平行算法：for_each、transform、reduce、sort、fill、copy
+//
+
+#ifndef SEQUENCE_CONTAINERS_PARALLEL_ALGORITHMS_H
+#define SEQUENCE_CONTAINERS_PARALLEL_ALGORITHMS_H
+
+#include <algorithm>    // for sort, inplace_merge, rotate, transform, max
+#include "sequence_containers.h"
+
+// 区间切成若干块，每块作为一个任务交给线程池(工作窃取)，调用者在等待时也帮忙执行
+// 迭代器必须是随机存取的：切块时以O(1)的+=找出每块的边界
+// deque的迭代器切在缓冲区的边界上，每个任务处理整数个缓冲区，块内走分段算法(原生指针、SIMD)
+// 切多少块由partitioner决定：
+//     static_partitioner      每个工作线程一块，任务最少，适合每个元素成本相同的工作
+//     auto_partitioner        每个工作线程约4块，但每块不少于LYH_PARALLEL_MIN_GRAIN个元素，
+//                             成本不均时由工作窃取平衡负载(缺省)
+//     grain_partitioner(g)    每块g个元素
+// 函数对象会被多个线程同时调用，必须能够并行执行
+
+// auto_partitioner每块至少的元素个数
+#ifndef LYH_PARALLEL_MIN_GRAIN
+# define LYH_PARALLEL_MIN_GRAIN 2048
+#endif
+
+namespace LYH
+{
+    // 传回每块的元素个数，n为元素总数，workers为工作线程数
+    struct static_partitioner
+    {
+        size_t chunk_size( size_t n, size_t workers ) const { return ( n + workers - 1 ) / workers; }
+    };
+    struct auto_partitioner
+    {
+        size_t chunk_size( size_t n, size_t workers ) const
+        {
+            size_t c = ( n + 4 * workers - 1 ) / ( 4 * workers );
+            return c < LYH_PARALLEL_MIN_GRAIN ? LYH_PARALLEL_MIN_GRAIN : c;
+        }
+    };
+    struct grain_partitioner
+    {
+        explicit grain_partitioner( size_t grain ) : grain(grain) {}
+        size_t chunk_size( size_t, size_t ) const { return grain; }
+        size_t grain;
+    };
+
+    // 块的边界对齐的单位，以及区间的头在此单位中的位置
+    // 一般的迭代器不必对齐；deque的迭代器对齐到缓冲区
+    template <class RandomAccessIterator>
+    inline ptrdiff_t __parallel_align( const RandomAccessIterator& ) { return 1; }
+    template <class RandomAccessIterator>
+    inline ptrdiff_t __parallel_phase( const RandomAccessIterator& ) { return 0; }
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact>
+    inline ptrdiff_t __parallel_align( const __deque_iterator<T, Ref, Ptr, BufSiz, Compact>& )
+    {
+        return ptrdiff_t( __deque_iterator<T, Ref, Ptr, BufSiz, Compact>::buffer_size() );
+    }
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact>
+    inline ptrdiff_t __parallel_phase( const __deque_iterator<T, Ref, Ptr, BufSiz, Compact>& it )
+    {
+        return it.cur - it.buf_first();
+    }
+
+    // 算出各块的边界(相对于first的偏移)：bounds为0, b1, b2, ..., n
+    template <class RandomAccessIterator, class Partitioner>
+    void __parallel_bounds( RandomAccessIterator first, RandomAccessIterator last, const Partitioner& part,
+                            thread_pool& pool, vector<ptrdiff_t>& bounds )
+    {
+        static_assert( __is_random_access_iterator<RandomAccessIterator>::value,
+                       "parallel algorithms require random access iterators" );
+        ptrdiff_t n = last - first;
+        bounds.push_back( 0 );
+        if( n <= 0 )
+            return;
+        ptrdiff_t align = __parallel_align( first );
+        ptrdiff_t phase = __parallel_phase( first );
+        ptrdiff_t c = ptrdiff_t( part.chunk_size( size_t( n ), pool.size() ) );
+        if( c < 1 )
+            c = 1;
+        c = ( c + align - 1 ) / align * align;
+        // 第一块截到缓冲区的边界，之后每块都从缓冲区的开头开始
+        for( ptrdiff_t hi = c - phase; hi < n; hi += c )
+            bounds.push_back( hi );
+        bounds.push_back( n );
+    }
+
+    // 每块执行一次body(块头, 块尾, 块头相对于first的偏移)，只有一块时直接在调用者执行
+    template <class RandomAccessIterator, class Partitioner, class Body>
+    void __parallel_chunks( RandomAccessIterator first, RandomAccessIterator last, const Partitioner& part,
+                            thread_pool& pool, const Body& body )
+    {
+        vector<ptrdiff_t> bounds;
+        __parallel_bounds( first, last, part, pool, bounds );
+        size_t k = bounds.size() - 1;
+        if( k == 0 )
+            return;
+        if( k == 1 )
+        {
+            body( first, last, 0 );
+            return;
+        }
+        task_group group( pool );
+        for( size_t i = 0; i < k; ++i )
+        {
+            ptrdiff_t lo = bounds[i];
+            RandomAccessIterator b = first + lo;
+            RandomAccessIterator e = first + bounds[i + 1];
+            const Body* f = &body;
+            group.run( [f, b, e, lo]{ (*f)( b, e, lo ); } );
+        }
+        group.wait();
+    }
+
+    // parallel_for_each：每块以for_each执行(deque走分段版本)
+    template <class RandomAccessIterator, class Function, class Partitioner>
+    void parallel_for_each( RandomAccessIterator first, RandomAccessIterator last, Function f,
+                            const Partitioner& part, thread_pool& pool )
+    {
+        __parallel_chunks( first, last, part, pool,
+                           [&f]( RandomAccessIterator b, RandomAccessIterator e, ptrdiff_t ){ LYH::for_each( b, e, f ); } );
+    }
+    template <class RandomAccessIterator, class Function, class Partitioner>
+    inline void parallel_for_each( RandomAccessIterator first, RandomAccessIterator last, Function f, const Partitioner& part )
+    {
+        parallel_for_each( first, last, f, part, default_thread_pool() );
+    }
+    template <class RandomAccessIterator, class Function>
+    inline void parallel_for_each( RandomAccessIterator first, RandomAccessIterator last, Function f )
+    {
+        parallel_for_each( first, last, f, auto_partitioner(), default_thread_pool() );
+    }
+
+    // parallel_transform：*(result + i) = op(*(first + i))，result也必须是随机存取迭代器
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class UnaryOperation, class Partitioner>
+    RandomAccessIterator2 parallel_transform( RandomAccessIterator1 first, RandomAccessIterator1 last,
+                                              RandomAccessIterator2 result, UnaryOperation op,
+                                              const Partitioner& part, thread_pool& pool )
+    {
+        __parallel_chunks( first, last, part, pool,
+                           [&op, result]( RandomAccessIterator1 b, RandomAccessIterator1 e, ptrdiff_t lo )
+                           { std::transform( b, e, result + lo, op ); } );
+        return result + ( last - first );
+    }
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class UnaryOperation, class Partitioner>
+    inline RandomAccessIterator2 parallel_transform( RandomAccessIterator1 first, RandomAccessIterator1 last,
+                                                     RandomAccessIterator2 result, UnaryOperation op, const Partitioner& part )
+    {
+        return parallel_transform( first, last, result, op, part, default_thread_pool() );
+    }
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class UnaryOperation>
+    inline RandomAccessIterator2 parallel_transform( RandomAccessIterator1 first, RandomAccessIterator1 last,
+                                                     RandomAccessIterator2 result, UnaryOperation op )
+    {
+        return parallel_transform( first, last, result, op, auto_partitioner(), default_thread_pool() );
+    }
+
+    // parallel_reduce：各块以accumulate求出部分和(deque走分段版本)，再依块的次序与init合并
+    // op必须满足结合律，各块内部与块之间的计算次序与循序的accumulate不同
+    template <class RandomAccessIterator, class T, class BinaryOperation, class Partitioner>
+    T parallel_reduce( RandomAccessIterator first, RandomAccessIterator last, T init, BinaryOperation op,
+                       const Partitioner& part, thread_pool& pool )
+    {
+        vector<ptrdiff_t> bounds;
+        __parallel_bounds( first, last, part, pool, bounds );
+        size_t k = bounds.size() - 1;
+        if( k == 0 )
+            return init;
+        vector<T> partial( k, init );
+        {
+            task_group group( pool );
+            for( size_t i = 0; i < k; ++i )
+            {
+                RandomAccessIterator b = first + bounds[i];
+                RandomAccessIterator e = first + bounds[i + 1];
+                T* p = &partial[i];
+                BinaryOperation* f = &op;
+                group.run( [p, f, b, e]{ *p = LYH::accumulate( b + 1, e, T( *b ), *f ); } );
+            }
+            group.wait();
+        }
+        for( size_t i = 0; i < k; ++i )
+            init = op( init, partial[i] );
+        return init;
+    }
+    template <class RandomAccessIterator, class T, class BinaryOperation, class Partitioner>
+    inline T parallel_reduce( RandomAccessIterator first, RandomAccessIterator last, T init, BinaryOperation op,
+                              const Partitioner& part )
+    {
+        return parallel_reduce( first, last, init, op, part, default_thread_pool() );
+    }
+    template <class RandomAccessIterator, class T, class BinaryOperation>
+    inline T parallel_reduce( RandomAccessIterator first, RandomAccessIterator last, T init, BinaryOperation op )
+    {
+        return parallel_reduce( first, last, init, op, auto_partitioner(), default_thread_pool() );
+    }
+    template <class RandomAccessIterator, class T>
+    inline T parallel_reduce( RandomAccessIterator first, RandomAccessIterator last, T init )
+    {
+        return parallel_reduce( first, last, init, std::plus<T>(), auto_partitioner(), default_thread_pool() );
+    }
+
+    // 合并[first, middle)与[middle, last)两段已排序的区间，与inplace_merge同样是稳定的
+    // 较长的一段取中点，在另一段中二分搜寻对应的位置，rotate之后切点两侧的合并互不相干：
+    // 左半交给group，右半由当前线程继续切，直到不大于grain时才就地合并
+    template <class RandomAccessIterator, class Compare>
+    void __parallel_merge( RandomAccessIterator first, RandomAccessIterator middle, RandomAccessIterator last,
+                           Compare comp, ptrdiff_t grain, task_group& group )
+    {
+        for( ;; )
+        {
+            ptrdiff_t len1 = middle - first;
+            ptrdiff_t len2 = last - middle;
+            if( len1 == 0 || len2 == 0 )
+                return;
+            // 两段各只有一个元素时切点不会前进，一定就地合并
+            if( len1 + len2 <= grain || len1 + len2 == 2 )
+            {
+                std::inplace_merge( first, middle, last, comp );
+                return;
+            }
+            RandomAccessIterator cut1, cut2;
+            if( len1 > len2 )
+            {
+                cut1 = first + len1 / 2;
+                cut2 = std::lower_bound( middle, last, *cut1, comp );
+            }
+            else
+            {
+                cut2 = middle + len2 / 2;
+                cut1 = std::upper_bound( first, middle, *cut2, comp );
+            }
+            RandomAccessIterator new_middle = std::rotate( cut1, middle, cut2 );
+            group.run( [first, cut1, new_middle, comp, grain, &group]
+                       { __parallel_merge( first, cut1, new_middle, comp, grain, group ); } );
+            first = new_middle;
+            middle = cut2;
+        }
+    }
+
+    // parallel_sort：各块平行排序，再两两合并
+    // 同一层的合并平行进行，每个合并再由__parallel_merge切成块大小的小合并，最后几层也不会只剩一个线程在做
+    template <class RandomAccessIterator, class Compare, class Partitioner>
+    void parallel_sort( RandomAccessIterator first, RandomAccessIterator last, Compare comp,
+                        const Partitioner& part, thread_pool& pool )
+    {
+        vector<ptrdiff_t> bounds;
+        __parallel_bounds( first, last, part, pool, bounds );
+        size_t k = bounds.size() - 1;
+        if( k <= 1 )
+        {
+            std::sort( first, last, comp );
+            return;
+        }
+        task_group group( pool );
+        for( size_t i = 0; i < k; ++i )
+        {
+            RandomAccessIterator b = first + bounds[i];
+            RandomAccessIterator e = first + bounds[i + 1];
+            group.run( [b, e, comp]{ std::sort( b, e, comp ); } );
+        }
+        group.wait();
+        // 合并的块大小取分块的标准大小：deque的第一块截到缓冲区的边界，最后一块是余数，
+        // 中间的块才是完整的一块；只有两块时取较大者
+        const ptrdiff_t grain = k > 2 ? bounds[2] - bounds[1]
+                                      : std::max( bounds[1] - bounds[0], bounds[2] - bounds[1] );
+        for( size_t step = 1; step < k; step *= 2 )
+        {
+            for( size_t i = 0; i + step < k; i += 2 * step )
+            {
+                RandomAccessIterator b = first + bounds[i];
+                RandomAccessIterator m = first + bounds[i + step];
+                RandomAccessIterator e = first + bounds[std::min( i + 2 * step, k )];
+                group.run( [b, m, e, comp, grain, &group]{ __parallel_merge( b, m, e, comp, grain, group ); } );
+            }
+            group.wait();
+        }
+    }
+    template <class RandomAccessIterator, class Compare, class Partitioner>
+    inline void parallel_sort( RandomAccessIterator first, RandomAccessIterator last, Compare comp, const Partitioner& part )
+    {
+        parallel_sort( first, last, comp, part, default_thread_pool() );
+    }
+    template <class RandomAccessIterator, class Compare>
+    inline void parallel_sort( RandomAccessIterator first, RandomAccessIterator last, Compare comp )
+    {
+        parallel_sort( first, last, comp, auto_partitioner(), default_thread_pool() );
+    }
+    template <class RandomAccessIterator>
+    inline void parallel_sort( RandomAccessIterator first, RandomAccessIterator last )
+    {
+        typedef typename iterator_traits<RandomAccessIterator>::value_type T;
+        parallel_sort( first, last, std::less<T>(), auto_partitioner(), default_thread_pool() );
+    }
+
+    // parallel_fill：每块以fill执行(原生指针走memset、SIMD，deque走分段版本)
+    template <class RandomAccessIterator, class T, class Partitioner>
+    void parallel_fill( RandomAccessIterator first, RandomAccessIterator last, const T& value,
+                        const Partitioner& part, thread_pool& pool )
+    {
+        __parallel_chunks( first, last, part, pool,
+                           [&value]( RandomAccessIterator b, RandomAccessIterator e, ptrdiff_t ){ LYH::fill( b, e, value ); } );
+    }
+    template <class RandomAccessIterator, class T, class Partitioner>
+    inline void parallel_fill( RandomAccessIterator first, RandomAccessIterator last, const T& value, const Partitioner& part )
+    {
+        parallel_fill( first, last, value, part, default_thread_pool() );
+    }
+    template <class RandomAccessIterator, class T>
+    inline void parallel_fill( RandomAccessIterator first, RandomAccessIterator last, const T& value )
+    {
+        parallel_fill( first, last, value, auto_partitioner(), default_thread_pool() );
+    }
+
+    // parallel_copy：每块以copy执行(原生指针走SIMD，deque走分段版本)，两个区间不得重叠
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class Partitioner>
+    RandomAccessIterator2 parallel_copy( RandomAccessIterator1 first, RandomAccessIterator1 last,
+                                         RandomAccessIterator2 result, const Partitioner& part, thread_pool& pool )
+    {
+        __parallel_chunks( first, last, part, pool,
+                           [result]( RandomAccessIterator1 b, RandomAccessIterator1 e, ptrdiff_t lo )
+                           { LYH::copy( b, e, result + lo ); } );
+        return result + ( last - first );
+    }
+    template <class RandomAccessIterator1, class RandomAccessIterator2, class Partitioner>
+    inline RandomAccessIterator2 parallel_copy( RandomAccessIterator1 first, RandomAccessIterator1 last,
+                                                RandomAccessIterator2 result, const Partitioner& part )
+    {
+        return parallel_copy( first, last, result, part, default_thread_pool() );
+    }
+    template <class RandomAccessIterator1, class RandomAccessIterator2>
+    inline RandomAccessIterator2 parallel_copy( RandomAccessIterator1 first, RandomAccessIterator1 last,
+                                                RandomAccessIterator2 result )
+    {
+        return parallel_copy( first, last, result, auto_partitioner(), default_thread_pool() );
+    }
+}
+
+#endif //SEQUENCE_CONTAINERS_PARALLEL_ALGORITHMS_H
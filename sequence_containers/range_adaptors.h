@@ -0,0 +1,495 @@
+//
+// 惰性的区间适配器：transform、filter、take、zip、chunk
+//
+
+#ifndef SEQUENCE_CONTAINERS_RANGE_ADAPTORS_H
+#define SEQUENCE_CONTAINERS_RANGE_ADAPTORS_H
+
+#include <algorithm>    // for min
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "iterator_traits.h"
+
+// 每个适配器只是一对迭代器，元素在走访时才逐一计算，串接多个步骤也只走访一次，
+// 中间不产生临时容器，例如
+//     for( auto x : v | filtered( is_odd ) | transformed( square ) | taken( 10 ) ) ...
+// 适配器只记住底层区间的迭代器，不拥有元素：底层容器必须比适配器活得久
+// 适配后的迭代器类型取底层类型与适配器所能支持者中较弱的一个，
+// 随机存取的管线因此仍能以O(1)执行advance、distance
+namespace LYH
+{
+    // 两种迭代器类型中较弱的一个
+    template <class Category1, class Category2>
+    struct __weaker_category
+    {
+        typedef typename std::conditional< std::is_convertible<Category1, Category2>::value,
+                                           Category2, Category1 >::type type;
+    };
+
+    // 区间：一对迭代器，可以直接用于range-for
+    template <class Iterator>
+    class iterator_range
+    {
+    public:
+        typedef Iterator iterator;
+        typedef typename iterator_traits<Iterator>::difference_type difference_type;
+
+        iterator_range() {}
+        iterator_range( Iterator first, Iterator last ) : first(first), last(last) {}
+
+        Iterator begin() const { return first; }
+        Iterator end() const { return last; }
+        bool empty() const { return first == last; }
+        // 随机存取的区间为O(1)，其余逐一计数
+        difference_type size() const { return LYH::distance( first, last ); }
+
+    private:
+        Iterator first;
+        Iterator last;
+    };
+
+    template <class Iterator>
+    inline iterator_range<Iterator> make_range( Iterator first, Iterator last )
+    {
+        return iterator_range<Iterator>( first, last );
+    }
+
+    // 任何有begin()、end()的区间(容器或iterator_range)的迭代器型别
+    template <class Range>
+    struct __range_iterator
+    {
+        typedef decltype( std::declval<Range&>().begin() ) type;
+    };
+
+    // 函数对象的容器
+    // lambda没有默认构造函数，也不能赋值，直接作为成员会使迭代器无法赋值；
+    // 这里以就地构造代替赋值，默认构造时为空
+    template <class F>
+    class __function_box
+    {
+    public:
+        __function_box() : engaged(false) {}
+        explicit __function_box( const F& f ) : engaged(true) { new ((void*) &buf) F( f ); }
+        __function_box( const __function_box& x ) : engaged(false) { *this = x; }
+        __function_box& operator=( const __function_box& x )
+        {
+            if( this != &x )
+            {
+                reset();
+                if( x.engaged )
+                {
+                    new ((void*) &buf) F( x.get() );
+                    engaged = true;
+                }
+            }
+            return *this;
+        }
+        ~__function_box() { reset(); }
+
+        const F& get() const { return *reinterpret_cast<const F*>( &buf ); }
+
+    private:
+        typename std::aligned_storage<sizeof(F), alignof(F)>::type buf;
+        bool engaged;
+
+        void reset()
+        {
+            if( engaged )
+                reinterpret_cast<F*>( &buf )->~F();
+            engaged = false;
+        }
+    };
+
+    // transform：*it为f(*base)，每次解引用时才计算
+    // 元素由函数算出，不再连续存放，类型最高为随机存取
+    template <class Iterator, class F>
+    class transform_iterator
+        : public iterator< typename __weaker_category< typename iterator_traits<Iterator>::iterator_category,
+                                                       random_access_iterator_tag >::type,
+                           typename std::decay< typename std::result_of<
+                                   const F&( typename iterator_traits<Iterator>::reference ) >::type >::type,
+                           typename iterator_traits<Iterator>::difference_type,
+                           void,
+                           typename std::result_of< const F&( typename iterator_traits<Iterator>::reference ) >::type >
+    {
+    public:
+        typedef transform_iterator self;
+        typedef typename std::result_of< const F&( typename iterator_traits<Iterator>::reference ) >::type reference;
+        typedef typename iterator_traits<Iterator>::difference_type difference_type;
+
+        transform_iterator() {}
+        transform_iterator( Iterator it, const F& f ) : cur(it), f(f) {}
+
+        Iterator base() const { return cur; }
+
+        reference operator*() const { return f.get()( *cur ); }
+        reference operator[]( difference_type n ) const { return f.get()( cur[n] ); }
+
+        self& operator++() { ++cur; return *this; }
+        self operator++(int) { self tmp = *this; ++cur; return tmp; }
+        self& operator--() { --cur; return *this; }
+        self operator--(int) { self tmp = *this; --cur; return tmp; }
+        self& operator+=( difference_type n ) { cur += n; return *this; }
+        self& operator-=( difference_type n ) { cur -= n; return *this; }
+        self operator+( difference_type n ) const { self tmp = *this; return tmp += n; }
+        self operator-( difference_type n ) const { self tmp = *this; return tmp -= n; }
+        difference_type operator-( const self& x ) const { return cur - x.cur; }
+
+        bool operator==( const self& x ) const { return cur == x.cur; }
+        bool operator!=( const self& x ) const { return cur != x.cur; }
+        bool operator< ( const self& x ) const { return cur < x.cur; }
+        bool operator> ( const self& x ) const { return x.cur < cur; }
+        bool operator<=( const self& x ) const { return !( x.cur < cur ); }
+        bool operator>=( const self& x ) const { return !( cur < x.cur ); }
+
+    private:
+        Iterator cur;
+        __function_box<F> f;
+    };
+
+    // filter：只走访pred(*it)为真的元素
+    // 跳过多少元素事先无从得知，类型最高为双向；
+    // 向前走需要知道底层区间的尾端，向后走则由区间的前提保证前面还有符合的元素
+    template <class Iterator, class Predicate>
+    class filter_iterator
+        : public iterator< typename __weaker_category< typename iterator_traits<Iterator>::iterator_category,
+                                                       bidirectional_iterator_tag >::type,
+                           typename iterator_traits<Iterator>::value_type,
+                           typename iterator_traits<Iterator>::difference_type,
+                           typename iterator_traits<Iterator>::pointer,
+                           typename iterator_traits<Iterator>::reference >
+    {
+    public:
+        typedef filter_iterator self;
+        typedef typename iterator_traits<Iterator>::reference reference;
+        typedef typename iterator_traits<Iterator>::pointer pointer;
+
+        filter_iterator() {}
+        // 停在[it, last)中第一个符合的元素上
+        filter_iterator( Iterator it, Iterator last, const Predicate& pred ) : cur(it), last(last), pred(pred)
+        {
+            satisfy();
+        }
+
+        Iterator base() const { return cur; }
+
+        reference operator*() const { return *cur; }
+        pointer operator->() const { return &*cur; }
+
+        self& operator++() { ++cur; satisfy(); return *this; }
+        self operator++(int) { self tmp = *this; ++*this; return tmp; }
+        self& operator--()
+        {
+            do
+                --cur;
+            while( !pred.get()( *cur ) );
+            return *this;
+        }
+        self operator--(int) { self tmp = *this; --*this; return tmp; }
+
+        bool operator==( const self& x ) const { return cur == x.cur; }
+        bool operator!=( const self& x ) const { return cur != x.cur; }
+
+    private:
+        Iterator cur;
+        Iterator last;
+        __function_box<Predicate> pred;
+
+        void satisfy()
+        {
+            while( cur != last && !pred.get()( *cur ) )
+                ++cur;
+        }
+    };
+
+    // take：至多走访n个元素
+    // 随机存取的底层区间直接截出[first, first + min(n, 长度))，不需要这个迭代器；
+    // 其余的区间以计数器记录走了几步，走满n步或走到底层区间的尾端都视为结束，类型最高为单向
+    template <class Iterator>
+    class take_iterator
+        : public iterator< typename __weaker_category< typename iterator_traits<Iterator>::iterator_category,
+                                                       forward_iterator_tag >::type,
+                           typename iterator_traits<Iterator>::value_type,
+                           typename iterator_traits<Iterator>::difference_type,
+                           typename iterator_traits<Iterator>::pointer,
+                           typename iterator_traits<Iterator>::reference >
+    {
+    public:
+        typedef take_iterator self;
+        typedef typename iterator_traits<Iterator>::reference reference;
+        typedef typename iterator_traits<Iterator>::pointer pointer;
+        typedef typename iterator_traits<Iterator>::difference_type difference_type;
+
+        take_iterator() : count(0) {}
+        take_iterator( Iterator it, difference_type count ) : cur(it), count(count) {}
+
+        Iterator base() const { return cur; }
+
+        reference operator*() const { return *cur; }
+        pointer operator->() const { return &*cur; }
+
+        self& operator++() { ++cur; ++count; return *this; }
+        self operator++(int) { self tmp = *this; ++*this; return tmp; }
+
+        // 尾端为(底层尾端, n)：计数到n或底层走到尾端，两者之一成立即相等
+        bool operator==( const self& x ) const { return count == x.count || cur == x.cur; }
+        bool operator!=( const self& x ) const { return !( *this == x ); }
+
+    private:
+        Iterator cur;
+        difference_type count;
+    };
+
+    // zip：同时走访两个区间，*it为两边引用组成的pair，长度取较短者
+    // 两边都随机存取时尾端对齐在较短者的长度上，仍是随机存取；否则尾端是两边各自的尾端，
+    // 长度不同时从尾端往回走会错位，类型最高为单向
+    template <class Iterator1, class Iterator2>
+    class zip_iterator
+        : public iterator< typename std::conditional< __is_random_access_iterator<Iterator1>::value &&
+                                                      __is_random_access_iterator<Iterator2>::value,
+                                                      random_access_iterator_tag,
+                                                      typename __weaker_category<
+                                                              typename __weaker_category< typename iterator_traits<Iterator1>::iterator_category,
+                                                                                          typename iterator_traits<Iterator2>::iterator_category >::type,
+                                                              forward_iterator_tag >::type >::type,
+                           std::pair< typename iterator_traits<Iterator1>::value_type,
+                                      typename iterator_traits<Iterator2>::value_type >,
+                           typename iterator_traits<Iterator1>::difference_type,
+                           void,
+                           std::pair< typename iterator_traits<Iterator1>::reference,
+                                      typename iterator_traits<Iterator2>::reference > >
+    {
+    public:
+        typedef zip_iterator self;
+        typedef std::pair< typename iterator_traits<Iterator1>::reference,
+                           typename iterator_traits<Iterator2>::reference > reference;
+        typedef typename iterator_traits<Iterator1>::difference_type difference_type;
+
+        zip_iterator() {}
+        zip_iterator( Iterator1 it1, Iterator2 it2 ) : cur1(it1), cur2(it2) {}
+
+        Iterator1 base1() const { return cur1; }
+        Iterator2 base2() const { return cur2; }
+
+        reference operator*() const { return reference( *cur1, *cur2 ); }
+        reference operator[]( difference_type n ) const { return reference( cur1[n], cur2[n] ); }
+
+        self& operator++() { ++cur1; ++cur2; return *this; }
+        self operator++(int) { self tmp = *this; ++*this; return tmp; }
+        self& operator--() { --cur1; --cur2; return *this; }
+        self operator--(int) { self tmp = *this; --*this; return tmp; }
+        self& operator+=( difference_type n ) { cur1 += n; cur2 += n; return *this; }
+        self& operator-=( difference_type n ) { cur1 -= n; cur2 -= n; return *this; }
+        self operator+( difference_type n ) const { self tmp = *this; return tmp += n; }
+        self operator-( difference_type n ) const { self tmp = *this; return tmp -= n; }
+        difference_type operator-( const self& x ) const { return cur1 - x.cur1; }
+
+        // 任一边走到尾端即结束，长度不同的两个单向区间也不会越界
+        bool operator==( const self& x ) const { return cur1 == x.cur1 || cur2 == x.cur2; }
+        bool operator!=( const self& x ) const { return !( *this == x ); }
+        bool operator< ( const self& x ) const { return cur1 < x.cur1; }
+        bool operator> ( const self& x ) const { return x.cur1 < cur1; }
+        bool operator<=( const self& x ) const { return !( x.cur1 < cur1 ); }
+        bool operator>=( const self& x ) const { return !( cur1 < x.cur1 ); }
+
+    private:
+        Iterator1 cur1;
+        Iterator2 cur2;
+    };
+
+    // chunk：把区间切成每段n个元素(最后一段可能不足)，*it为一段的iterator_range
+    // 底层为随机存取时一步跳过整段，仍是随机存取；否则逐一前进，类型最高为单向
+    template <class Iterator>
+    class chunk_iterator
+        : public iterator< typename std::conditional< __is_random_access_iterator<Iterator>::value,
+                                                      random_access_iterator_tag,
+                                                      typename __weaker_category<
+                                                              typename iterator_traits<Iterator>::iterator_category,
+                                                              forward_iterator_tag >::type >::type,
+                           iterator_range<Iterator>,
+                           typename iterator_traits<Iterator>::difference_type,
+                           void,
+                           iterator_range<Iterator> >
+    {
+    public:
+        typedef chunk_iterator self;
+        typedef iterator_range<Iterator> reference;
+        typedef typename iterator_traits<Iterator>::difference_type difference_type;
+
+        chunk_iterator() : n(1) {}
+        chunk_iterator( Iterator first, Iterator it, Iterator last, difference_type n )
+            : first(first), cur(it), last(last), n(n) {}
+
+        reference operator*() const { return reference( cur, step( cur, n ) ); }
+        reference operator[]( difference_type k ) const { return *( *this + k ); }
+
+        self& operator++() { cur = step( cur, n ); return *this; }
+        self operator++(int) { self tmp = *this; ++*this; return tmp; }
+        // 向后走时落在n的整数倍上，最后一段不足n个也不影响
+        self& operator--() { return *this -= 1; }
+        self operator--(int) { self tmp = *this; --*this; return tmp; }
+        self& operator+=( difference_type k )
+        {
+            if( k >= 0 )
+                cur = step( cur, k * n );
+            else
+                cur = first + ( ( cur - first + n - 1 ) / n + k ) * n;
+            return *this;
+        }
+        self& operator-=( difference_type k ) { return *this += -k; }
+        self operator+( difference_type k ) const { self tmp = *this; return tmp += k; }
+        self operator-( difference_type k ) const { self tmp = *this; return tmp -= k; }
+        // 段数，不足n个的最后一段也算一段
+        difference_type operator-( const self& x ) const
+        {
+            return ( cur - first + n - 1 ) / n - ( x.cur - first + n - 1 ) / n;
+        }
+
+        bool operator==( const self& x ) const { return cur == x.cur; }
+        bool operator!=( const self& x ) const { return cur != x.cur; }
+        bool operator< ( const self& x ) const { return cur < x.cur; }
+        bool operator> ( const self& x ) const { return x.cur < cur; }
+        bool operator<=( const self& x ) const { return !( x.cur < cur ); }
+        bool operator>=( const self& x ) const { return !( cur < x.cur ); }
+
+    private:
+        Iterator first;     // 区间的头，随机存取时用来算出段的边界
+        Iterator cur;
+        Iterator last;
+        difference_type n;
+
+        // 从it前进k步，不超过last
+        Iterator step( Iterator it, difference_type k ) const
+        {
+            return step( it, k, iterator_category( it ) );
+        }
+        Iterator step( Iterator it, difference_type k, input_iterator_tag ) const
+        {
+            for( ; k > 0 && it != last; --k )
+                ++it;
+            return it;
+        }
+        Iterator step( Iterator it, difference_type k, random_access_iterator_tag ) const
+        {
+            return last - it > k ? it + k : last;
+        }
+    };
+
+    // 建立适配后的区间
+    template <class Range, class F>
+    inline iterator_range< transform_iterator<typename __range_iterator<Range>::type, F> >
+    transformed( Range& r, const F& f )
+    {
+        typedef transform_iterator<typename __range_iterator<Range>::type, F> It;
+        return iterator_range<It>( It( r.begin(), f ), It( r.end(), f ) );
+    }
+
+    template <class Range, class Predicate>
+    inline iterator_range< filter_iterator<typename __range_iterator<Range>::type, Predicate> >
+    filtered( Range& r, const Predicate& pred )
+    {
+        typedef filter_iterator<typename __range_iterator<Range>::type, Predicate> It;
+        return iterator_range<It>( It( r.begin(), r.end(), pred ), It( r.end(), r.end(), pred ) );
+    }
+
+    // 随机存取：直接截断，迭代器型别不变
+    template <class Iterator, class Distance>
+    inline iterator_range<Iterator> __taken( Iterator first, Iterator last, Distance n, random_access_iterator_tag )
+    {
+        return iterator_range<Iterator>( first, last - first > n ? first + n : last );
+    }
+    template <class Iterator, class Distance>
+    inline iterator_range< take_iterator<Iterator> > __taken( Iterator first, Iterator last, Distance n, input_iterator_tag )
+    {
+        typedef take_iterator<Iterator> It;
+        return iterator_range<It>( It( first, 0 ), It( last, n ) );
+    }
+    template <class Range>
+    inline auto taken( Range& r, typename iterator_traits<typename __range_iterator<Range>::type>::difference_type n )
+        -> decltype( LYH::__taken( r.begin(), r.end(), n, iterator_category( r.begin() ) ) )
+    {
+        return LYH::__taken( r.begin(), r.end(), n, iterator_category( r.begin() ) );
+    }
+
+    // 随机存取时尾端取在较短者的长度上，其余依靠zip_iterator的==判断
+    template <class Iterator1, class Iterator2>
+    inline iterator_range< zip_iterator<Iterator1, Iterator2> >
+    __zipped( Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2, random_access_iterator_tag )
+    {
+        typedef zip_iterator<Iterator1, Iterator2> It;
+        typename It::difference_type n = std::min<typename It::difference_type>( last1 - first1, last2 - first2 );
+        return iterator_range<It>( It( first1, first2 ), It( first1 + n, first2 + n ) );
+    }
+    template <class Iterator1, class Iterator2>
+    inline iterator_range< zip_iterator<Iterator1, Iterator2> >
+    __zipped( Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2, input_iterator_tag )
+    {
+        typedef zip_iterator<Iterator1, Iterator2> It;
+        return iterator_range<It>( It( first1, first2 ), It( last1, last2 ) );
+    }
+    template <class Range1, class Range2>
+    inline iterator_range< zip_iterator<typename __range_iterator<Range1>::type, typename __range_iterator<Range2>::type> >
+    zipped( Range1& r1, Range2& r2 )
+    {
+        typedef zip_iterator<typename __range_iterator<Range1>::type, typename __range_iterator<Range2>::type> It;
+        return LYH::__zipped( r1.begin(), r1.end(), r2.begin(), r2.end(), typename It::iterator_category() );
+    }
+
+    template <class Range>
+    inline iterator_range< chunk_iterator<typename __range_iterator<Range>::type> >
+    chunked( Range& r, typename iterator_traits<typename __range_iterator<Range>::type>::difference_type n )
+    {
+        typedef chunk_iterator<typename __range_iterator<Range>::type> It;
+        return iterator_range<It>( It( r.begin(), r.begin(), r.end(), n ), It( r.begin(), r.end(), r.end(), n ) );
+    }
+
+    // 管线写法：r | transformed( f ) | filtered( p ) | taken( n )
+    // 单参数的版本只记下参数，operator|再把左边的区间交给上面的双参数版本
+    template <class F>
+    struct __transform_holder { F f; };
+    template <class Predicate>
+    struct __filter_holder { Predicate pred; };
+    struct __take_holder { ptrdiff_t n; };
+    template <class Range2>
+    struct __zip_holder { Range2* r2; };
+    struct __chunk_holder { ptrdiff_t n; };
+
+    template <class F>
+    inline __transform_holder<F> transformed( const F& f ) { __transform_holder<F> h = { f }; return h; }
+    template <class Predicate>
+    inline __filter_holder<Predicate> filtered( const Predicate& pred ) { __filter_holder<Predicate> h = { pred }; return h; }
+    inline __take_holder taken( ptrdiff_t n ) { __take_holder h = { n }; return h; }
+    template <class Range2>
+    inline __zip_holder<Range2> zipped( Range2& r2 ) { __zip_holder<Range2> h = { &r2 }; return h; }
+    inline __chunk_holder chunked( ptrdiff_t n ) { __chunk_holder h = { n }; return h; }
+
+    // 左边可以是容器(左值)或上一步产生的iterator_range(暂时物件)
+    template <class Range, class F>
+    inline auto operator|( Range&& r, const __transform_holder<F>& h ) -> decltype( LYH::transformed( r, h.f ) )
+    {
+        return LYH::transformed( r, h.f );
+    }
+    template <class Range, class Predicate>
+    inline auto operator|( Range&& r, const __filter_holder<Predicate>& h ) -> decltype( LYH::filtered( r, h.pred ) )
+    {
+        return LYH::filtered( r, h.pred );
+    }
+    template <class Range>
+    inline auto operator|( Range&& r, const __take_holder& h ) -> decltype( LYH::taken( r, h.n ) )
+    {
+        return LYH::taken( r, h.n );
+    }
+    template <class Range, class Range2>
+    inline auto operator|( Range&& r, const __zip_holder<Range2>& h ) -> decltype( LYH::zipped( r, *h.r2 ) )
+    {
+        return LYH::zipped( r, *h.r2 );
+    }
+    template <class Range>
+    inline auto operator|( Range&& r, const __chunk_holder& h ) -> decltype( LYH::chunked( r, h.n ) )
+    {
+        return LYH::chunked( r, h.n );
+    }
+}
+
+#endif //SEQUENCE_CONTAINERS_RANGE_ADAPTORS_H
@@ -6,19 +6,46 @@
 #define SEQUENCE_CONTAINERS_SEQUENCE_CONTAINERS_H
 
 #include <iostream>
+#include <memory>       // for uninitialized_fill
+#include <algorithm>    // for max, swap
+#include <type_traits>  // for is_same
+#include <atomic>       // for 预取距离
 #include "LYH.h"
+#include "thread_pool.h"
 
 using namespace LYH;
 
+// 标签：要求元素只做默认初始化，POD型别不会被清零
+struct default_init_t {};
+const default_init_t default_init = default_init_t();
 
-template <class T, class Alloc = alloc>
-class vector
+
+// vector的内嵌缓冲区
+// InlineN为0时是空类,不占用vector的任何空间
+template <class T, size_t InlineN>
+struct __vector_inline_buffer
+{
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[InlineN];
+    T* inline_begin() { return reinterpret_cast<T*>( buf ); }
+};
+
+template <class T>
+struct __vector_inline_buffer<T, 0>
+{
+    T* inline_begin() { return 0; }
+};
+
+// InlineN 指出内嵌缓冲区可容纳的元素个数
+// 前InlineN个元素直接存放在对象内部,超出后才向配置器申请空间
+template <class T, class Alloc = alloc, size_t InlineN = 0>
+class vector : protected __vector_inline_buffer<T, InlineN>
 {
 public:
     // 内嵌型定义
     typedef T                    value_type;
     typedef value_type*          pointer;
     typedef value_type*          iterator;      // vector维护连续线性空间，迭代器为普通指针
+    typedef const value_type*    const_iterator;
     typedef value_type&          reference;
     typedef const value_type&    const_reference;
     typedef size_t               size_type;
@@ -26,6 +53,7 @@ public:
 
 protected:
     typedef simple_alloc<value_type, Alloc> data_allocator;
+    typedef typename __type_traits<T>::has_trivial_relocate trivial_relocate;
     iterator start;             // 表示目前使用空间的头
     iterator finish;            // 表示目前使用空间的尾，永远指向一个空对象
     iterator end_of_storage;    // 表示目前可用空间的尾
@@ -37,7 +65,7 @@ protected:
             construct( finish, *(finish - 1) );
             ++finish;
             T x_copy = x;
-            std::copy_backward( position, finish-2, finish-1 );
+            LYH::copy_backward( position, finish-2, finish-1 );
             *position = x_copy;
         }
         else
@@ -45,69 +73,204 @@ protected:
             // 没有备用空间了
             const size_type old_size = size();
             const size_type len = old_size != 0? 2 * old_size : 1;
-            // 新开辟空间
+            // 新开辟空间，先在安插点构造新元素(x可能正是原vector中的元素)
             iterator new_start = data_allocator::allocate( len );
-            iterator new_finish = new_start;
             try
             {
-                new_finish = uninitialized_fill_copy( start, position, new_start );
-                construct( new_finish, x );
-                ++new_finish;
-                // 将安插点的原内容也拷贝过来
-                new_finish = uninitialized_fill_copy( position, finish, new_finish );
+                construct( new_start + ( position - start ), x );
             }
             catch(...)
             {
-                destroy( new_start, new_finish );
                 data_allocator::deallocate( new_start, len );
                 throw;
             }
-
-            // 析构并释放原vector
-            destroy( begin(), end() );
-            deallocate();
-
-            // 调整迭代器，指向新的vector
-            start = new_start;
-            finish = new_finish;
-            end_of_storage = new_start + len;
+            // 再将原内容搬到新元素的两侧，释放原vector
+            relocate_around( position, new_start, 1, len, trivial_relocate() );
+        }
+    }
+    // 重新配置空间的最后一步：新空间中安插点处的n个新元素已经构造好，
+    // 把原有的元素搬到它们两侧，释放原空间，调整迭代器指向新空间
+    // 元素trivially relocatable时整块逐字节搬移，原元素不必析构，也不会抛出异常
+    void relocate_around( iterator position, iterator new_start, size_type n, size_type len, __true_type )
+    {
+        iterator new_position = new_start + ( position - start );
+        const size_type new_size = size() + n;
+        __uninitialized_relocate( start, position, new_start, __true_type() );
+        __uninitialized_relocate( position, finish, new_position + n, __true_type() );
+        deallocate();
+        start = new_start;
+        finish = new_start + new_size;
+        end_of_storage = new_start + len;
+    }
+    // 否则逐个复制后析构原元素；复制中途抛出异常时，
+    // 析构新空间中已构造的元素并释放新空间，原vector保持不变(commit or rollback)
+    void relocate_around( iterator position, iterator new_start, size_type n, size_type len, __false_type )
+    {
+        iterator new_position = new_start + ( position - start );
+        iterator new_finish = new_position + n;
+        try
+        {
+            LYH::uninitialized_copy( start, position, new_start );
+        }
+        catch(...)
+        {
+            destroy( new_position, new_finish );
+            data_allocator::deallocate( new_start, len );
+            throw;
+        }
+        try
+        {
+            new_finish = LYH::uninitialized_copy( position, finish, new_finish );
         }
+        catch(...)
+        {
+            destroy( new_start, new_position + n );
+            data_allocator::deallocate( new_start, len );
+            throw;
+        }
+        destroy( start, finish );
+        deallocate();
+        start = new_start;
+        finish = new_finish;
+        end_of_storage = new_start + len;
     }
+    // 是否正在使用内嵌缓冲区,InlineN为0时恒为false
+    bool is_inline()
+        { return InlineN != 0 && start == this->inline_begin(); }
+    // 内嵌缓冲区不归配置器管理,不能还回去
     void deallocate()
     {
-        if( start )
-            data_allocator::deallocate( end_of_storage - start );
+        if( start && !is_inline() )
+            data_allocator::deallocate( start, end_of_storage - start );
     }
     void fill_initialize( size_type n, const_reference value )
     {
         start = allocate_and_fill( n, value );
         finish = start + n;
-        end_of_storage = finish;
+        end_of_storage = start + ( n < InlineN ? InlineN : n );
+    }
+    // 构造时配置空间，元素个数不超过InlineN时直接使用内嵌缓冲区
+    iterator initial_allocate( size_type n )
+    {
+        return n <= InlineN ? this->inline_begin() : data_allocator::allocate( n );
     }
     // 配置空间并填满内容
     iterator allocate_and_fill( size_type n, const_reference x )
     {
-        iterator result = data_allocator::allocate(n);
-        uninitialized_fill_n( result, n, x );
+        iterator result = initial_allocate(n);
+        LYH::uninitialized_fill_n( result, n, x );
+        return result;
+    }
+    // 在尾端追加n个只做默认初始化的元素
+    void default_append( size_type n )
+    {
+        if( n == 0 )
+            return;
+        if( size_type( end_of_storage - finish ) >= n )
+        {
+            finish = LYH::uninitialized_default_n( finish, n );
+        }
+        else
+        {
+            const size_type old_size = size();
+            const size_type len = old_size + std::max( old_size, n );
+            iterator new_start = data_allocator::allocate( len );
+            try
+            {
+                LYH::uninitialized_default_n( new_start + old_size, n );
+            }
+            catch(...)
+            {
+                data_allocator::deallocate( new_start, len );
+                throw;
+            }
+            relocate_around( finish, new_start, n, len, trivial_relocate() );
+        }
+    }
+    // 配置空间并复制[first,last)的内容，复制中途抛出异常时释放刚配置的空间
+    iterator allocate_and_copy( size_type n, const_iterator first, const_iterator last )
+    {
+        iterator result = initial_allocate(n);
+        try
+        {
+            LYH::uninitialized_copy( first, last, result );
+        }
+        catch(...)
+        {
+            if( n > InlineN )
+                data_allocator::deallocate( result, n );
+            throw;
+        }
         return result;
     }
 
 public:
     iterator begin() { return start; }
     iterator end()   { return finish; }
+    const_iterator begin() const { return start; }
+    const_iterator end()   const { return finish; }
     size_type size() const { return size_type( end() - begin() ); }
     size_type capacity() const
         { return size_type( end_of_storage - start ); }
-    bool empty() { return begin() - end() == 0; }
+    bool empty() const { return begin() == end(); }
     reference operator[]( size_type n )
         { return *(begin() + n); }
+    const_reference operator[]( size_type n ) const
+        { return *(begin() + n); }
 
     // ctor
-    vector() : start(0), finish(0), end_of_storage(0) {}
+    vector()
+    {
+        start = finish = this->inline_begin();
+        end_of_storage = start + InlineN;
+    }
     vector( size_type n, const_reference value ) { fill_initialize( n, value ); }
     vector( int n, const_reference value ) { fill_initialize( n, value ); }
     vector( long n, const_reference value ) { fill_initialize( n, value ); }
     explicit vector( size_type n ) { fill_initialize( n, T() ); }       // T的默认构造函数
+    // 只做默认初始化，POD型别的元素保持未初始化，适合随后会被整体覆盖的缓冲区
+    vector( size_type n, default_init_t )
+    {
+        start = initial_allocate( n );
+        finish = LYH::uninitialized_default_n( start, n );
+        end_of_storage = start + ( n < InlineN ? InlineN : n );
+    }
+    // 深拷贝，内嵌缓冲区中的元素同样要逐个复制
+    vector( const vector& x )
+    {
+        start = allocate_and_copy( x.size(), x.begin(), x.end() );
+        finish = start + x.size();
+        end_of_storage = start + ( x.size() < InlineN ? InlineN : x.size() );
+    }
+    vector& operator=( const vector& x )
+    {
+        if( &x != this )
+        {
+            const size_type xlen = x.size();
+            if( xlen > capacity() )
+            {
+                // 空间不足，重新配置
+                // xlen大于容量，也就大于InlineN，一定向配置器申请
+                iterator tmp = allocate_and_copy( xlen, x.begin(), x.end() );
+                destroy( start, finish );
+                deallocate();
+                start = tmp;
+                end_of_storage = start + xlen;
+            }
+            else if( size() >= xlen )
+            {
+                iterator i = LYH::copy( x.begin(), x.end(), begin() );
+                destroy( i, finish );
+            }
+            else
+            {
+                LYH::copy( x.begin(), x.begin() + size(), start );
+                LYH::uninitialized_copy( x.begin() + size(), x.end(), finish );
+            }
+            finish = start + xlen;
+        }
+        return *this;
+    }
 
     // dtor
     ~vector()
@@ -143,7 +306,7 @@ public:
     iterator erase( iterator position )
     {
         if( position + 1 != end() ) // position在有效区间内
-            bcopy( position+1, finish, position );  // 后续元素往前移动
+            LYH::copy( position+1, finish, position );  // 后续元素往前移动
         --finish;
         destroy(finish);
         return position;
@@ -151,7 +314,7 @@ public:
     // 清除[first,last)中的所有元素
     iterator erase( iterator first, iterator last )
     {
-        iterator i = std::copy( last, finish, first );
+        iterator i = LYH::copy( last, finish, first );
         destroy( i, finish );
         finish = finish - ( last - first );
         return first;
@@ -171,18 +334,18 @@ public:
             if( elems_after > n )
             {
                 // 插入点后的元素大于新增元素个数
-                std::uninitialized_copy( finish-n, finish, finish );
+                LYH::uninitialized_copy( finish-n, finish, finish );
                 finish += n;
-                std::copy_backward( position, old_finish-n, old_finish );
-                std::fill( position, position+n, x_copy );
+                LYH::copy_backward( position, old_finish-n, old_finish );
+                LYH::fill( position, position+n, x_copy );
             }
             else
             {
-                uninitialized_fill_n( finish, n-elems_after, x_copy );
+                LYH::uninitialized_fill_n( finish, n-elems_after, x_copy );
                 finish += n - elems_after;
-                std::uninitialized_copy( position, old_finish, finish );
+                LYH::uninitialized_copy( position, old_finish, finish );
                 finish += elems_after;
-                std::fill( position, old_finish, x_copy );
+                LYH::fill( position, old_finish, x_copy );
             }
         }
         else
@@ -190,24 +353,19 @@ public:
             // 备用空间小于新增元素个数，需决策新长度
             const size_type old_size = size();
             const size_type len = old_size + std::max( old_size, n );
-            // 配置新的vector空间
+            // 配置新的vector空间，先将插入元素放入新空间
             iterator new_start = data_allocator::allocate(len);
-            iterator new_finish = new_start;
-            // 插入点之前的元素复制到新空间
-            new_finish = std::uninitialized_copy( start, position, new_start );
-            // 将插入元素放入新空间
-            new_finish = uninitialized_fill_n( new_finish, n, x );
-            // 将插入点之后的元素复制到新空间
-            new_finish = std::uninitialized_copy( position, finish, new_finish );
-
-            // 清除并释放旧的vector
-            destroy( start, finish );
-            deallocate();
-
-            // 维护新的迭代器
-            start = new_start;
-            finish = new_finish;
-            end_of_storage = new_start + len;
+            try
+            {
+                LYH::uninitialized_fill_n( new_start + ( position - start ), n, x );
+            }
+            catch(...)
+            {
+                data_allocator::deallocate( new_start, len );
+                throw;
+            }
+            // 插入点前后的元素搬到新空间，清除并释放旧的vector
+            relocate_around( position, new_start, n, len, trivial_relocate() );
         }
 
     }
@@ -219,16 +377,55 @@ public:
             insert( end(), new_size - size(), x );
     }
     void resize( size_type new_size ) { resize( new_size, T() ); }
+    // 新增的元素只做默认初始化，POD型别不会被清零
+    void resize_default_init( size_type new_size )
+    {
+        if( new_size < size() )
+            erase( begin() + new_size, end() );
+        else
+            default_append( new_size - size() );
+    }
+    // 新增的元素保持未初始化，随后必须由调用者整体写入(例如read()或计算核心)
+    // 只接受POD型别
+    void resize_uninitialized( size_type new_size )
+    {
+        static_assert( std::is_same<typename __type_traits<T>::is_POD_type, __true_type>::value,
+                       "resize_uninitialized requires a POD element type" );
+        resize_default_init( new_size );
+    }
     void clear() { erase( begin(), end() ); }
 };
 
+// 元素可以逐字节比较时，equal与lexicographical_compare在原生指针上走memcmp
+template <class T, class Alloc, size_t InlineN>
+inline bool operator==( const vector<T, Alloc, InlineN>& x, const vector<T, Alloc, InlineN>& y )
+{
+    return x.size() == y.size() && LYH::equal( x.begin(), x.end(), y.begin() );
+}
+template <class T, class Alloc, size_t InlineN>
+inline bool operator!=( const vector<T, Alloc, InlineN>& x, const vector<T, Alloc, InlineN>& y )
+{
+    return !( x == y );
+}
+template <class T, class Alloc, size_t InlineN>
+inline bool operator<( const vector<T, Alloc, InlineN>& x, const vector<T, Alloc, InlineN>& y )
+{
+    return LYH::lexicographical_compare( x.begin(), x.end(), y.begin(), y.end() );
+}
+
+// 小缓冲区优化的vector,与vector共用全部算法
+// 前N个元素存放在对象内部,溢出时才向配置器(默认为内存池)申请空间
+template <class T, size_t N, class Alloc = alloc>
+using small_vector = vector<T, Alloc, N>;
+
 // node结构设计
+// prev必须是第一个成员：clear()将节点沿prev串成的链直接交还给配置器
+// 链接直接使用__list_node<T>*，走访时不必再转型
 template <class T>
 struct __list_node
 {
-    typedef void* void_pointer;
-    void_pointer prev;          // 型别为void*，足够灵活，其实可设为__list_node<T>*
-    void_pointer next;
+    __list_node<T>* prev;
+    __list_node<T>* next;
     T data;
 };
 // iterator结构设计
@@ -238,7 +435,7 @@ struct __list_iterator
     typedef __list_iterator<T, T&, T*> iterator;
     typedef __list_iterator<T, Ref, Ptr> self;
 
-    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef bidirectional_iterator_tag iterator_category;
     typedef T value_type;
     typedef Ptr pointer;
     typedef Ref reference;
@@ -251,7 +448,10 @@ struct __list_iterator
     // ctor
     __list_iterator(link_type x) : node(x){}
     __list_iterator(){}
-    __list_iterator(const iterator& x) : node(x.node){}
+    // iterator转为const_iterator；复制构造与赋值都由编译器产生
+    template <class R, class P>
+    __list_iterator(const __list_iterator<T, R, P>& x,
+                    typename std::enable_if<std::is_same<R, T&>::value>::type* = 0) : node(x.node){}
 
     bool operator==(const self& x) const
     { return node == x.node; }
@@ -265,7 +465,7 @@ struct __list_iterator
     // 对迭代器累加
     self& operator++()
     {
-        node = (link_type)((*node).next);
+        node = node->next;
         return *this;
     }
     self operator++(int)
@@ -277,7 +477,7 @@ struct __list_iterator
 
     self& operator--()
     {
-        node = (link_type)((*node).next);
+        node = node->prev;
         return *this;
     }
     self operator--(int)
@@ -287,6 +487,392 @@ struct __list_iterator
         return ret;
     }
 };
+
+// 萃取list迭代器所指之物的型别，供destroy等判断是否需要逐个析构
+template <class T, class Ref, class Ptr>
+inline T* value_type( const __list_iterator<T, Ref, Ptr>& )
+{
+    return static_cast<T*>(0);
+}
+
+// 走访链表时的预取距离：处理当前节点的同时，预取其后第k个节点，
+// 让节点的cache miss与元素的处理重叠；0表示不预取
+// 游标本身也要沿next逐个走过去，只有每个元素的处理够重时才划算，所以缺省不预取
+#ifndef LYH_LIST_PREFETCH_DISTANCE
+# define LYH_LIST_PREFETCH_DISTANCE 0
+#endif
+
+#if defined( __GNUC__ )
+# define __LYH_PREFETCH( p ) __builtin_prefetch( p )
+#else
+# define __LYH_PREFETCH( p ) ( (void) 0 )
+#endif
+
+// 平行的list::sort(pool)在工作线程上合并时也会读取，所以是atomic
+// 只是一个调校参数，不与其他数据同步，读写都用relaxed
+inline std::atomic<size_t>& __list_prefetch_distance_ref()
+{
+    static std::atomic<size_t> k( LYH_LIST_PREFETCH_DISTANCE );
+    return k;
+}
+// 执行期调整预取距离，节点散布得越开、每个元素的处理越轻，k应越大
+inline size_t list_prefetch_distance()
+{
+    return __list_prefetch_distance_ref().load( std::memory_order_relaxed );
+}
+inline void set_list_prefetch_distance( size_t k )
+{
+    __list_prefetch_distance_ref().store( k, std::memory_order_relaxed );
+}
+
+// 预取游标：始终走在迭代器前面k个节点，最远到last为止
+// 迭代器每前进一步就调用一次step()
+// 迭代器所在的节点及其之前的节点可以被移除，但不能移除游标与迭代器之间的节点
+template <class Iterator>
+struct __list_prefetcher
+{
+    typedef typename Iterator::link_type link_type;
+
+    link_type ahead;
+    link_type last;
+
+    __list_prefetcher( Iterator first, Iterator l ) : ahead(first.node), last(l.node)
+    {
+        size_t k = list_prefetch_distance();
+        if( k == 0 )
+            ahead = last;
+        for( ; k > 0 && ahead != last; --k )
+        {
+            ahead = ahead->next;
+            __LYH_PREFETCH( ahead );
+        }
+    }
+    void step()
+    {
+        if( ahead != last )
+        {
+            ahead = ahead->next;
+            __LYH_PREFETCH( ahead );
+        }
+    }
+};
+
+// 预取版本的for_each，供链表的迭代器使用
+template <class T, class Ref, class Ptr, class Function>
+Function for_each( __list_iterator<T, Ref, Ptr> first, __list_iterator<T, Ref, Ptr> last, Function f )
+{
+    __list_prefetcher< __list_iterator<T, Ref, Ptr> > pf( first, last );
+    for( ; first != last; ++first, pf.step() )
+        f( *first );
+    return f;
+}
+
+// 以下算法由list与intrusive_list共用，只通过节点的prev、next或链表的公开接口操作
+
+// 将[first,last)内的所有节点移动到position之前
+// 思路就是每变动一个指针,就会出现两个指针指向同一个节点情况,处理那个未变动的指针指向正确的位置
+template <class Node>
+inline void __list_transfer( Node* position, Node* first, Node* last )
+{
+    if( position != last )
+    {
+        last->prev->next = position;
+        position->prev->next = first;
+        first->prev->next = last;
+        Node* tmp = position->prev;
+        position->prev = last->prev;
+        last->prev = first->prev;
+        first->prev = tmp;
+    }
+}
+
+// 元素个数达到此值时，list::sort改用"收集-排序-回写"：
+// 先把节点收集到连续数组中排序，再一次走访重新串接；
+// 元素少时二进制计数合并排序的节点全在cache中，不值得另外配置数组
+#ifndef LYH_LIST_GATHER_SORT_MIN
+# define LYH_LIST_GATHER_SORT_MIN 4096
+#endif
+
+// 默认的比较方式，即operator<
+template <class T>
+struct __list_less
+{
+    bool operator()( const T& x, const T& y ) const { return x < y; }
+};
+
+// 将x合并到l上,两者都必须已经过comp递增排序
+// 相等的元素，l的在前；x的剩余部分整个接合，O(1)
+template <class List, class Compare>
+void __list_merge( List& l, List& x, Compare comp )
+{
+    typedef typename List::iterator iterator;
+    iterator first1 = l.begin();
+    iterator last1 = l.end();
+    iterator first2 = x.begin();
+    iterator last2 = x.end();
+    __list_prefetcher<iterator> pf1( first1, last1 );
+    __list_prefetcher<iterator> pf2( first2, last2 );
+
+    while( first1 != last1 && first2 != last2 )
+    {
+        if( comp( *first2, *first1 ) )
+        {
+            iterator next = first2;
+            ++next;
+            l.splice( first1, x, first2 );
+            first2 = next;
+            pf2.step();
+        }
+        else
+        {
+            ++first1;
+            pf1.step();
+        }
+    }
+    if( first2 != last2 )
+        l.splice( last1, x );
+}
+
+template <class List>
+inline void __list_merge( List& l, List& x )
+{
+    __list_merge( l, x, __list_less<typename List::value_type>() );
+}
+
+// 二进制计数的合并排序
+// carry与counter只是空的链表，元素以接合的方式在其间移动，不复制任何元素
+template <class List, class Compare>
+void __list_counter_sort( List& l, Compare comp )
+{
+    List carry;
+    List counter[64];
+    int fill = 0;
+    while( !l.empty() )
+    {
+        carry.splice( carry.begin(), l, l.begin() );
+        int i = 0;
+        while( i < fill && !counter[i].empty() )
+        {
+            __list_merge( counter[i], carry, comp );
+            carry.swap( counter[i++] );
+        }
+        carry.swap( counter[i] );
+        if( i == fill ) fill++;
+    }
+    for( int i = 1; i < fill; ++i )
+        __list_merge( counter[i], counter[i-1], comp );
+    l.swap( counter[fill - 1] );
+}
+
+// 收集数组中的一项：元素的副本与它所在的节点
+// 比较时只读连续数组，不必再跟着指针跳到各个节点
+template <class T, class Link>
+struct __list_sort_entry
+{
+    T key;
+    Link node;
+};
+
+template <class Entry, class Compare>
+struct __list_entry_compare
+{
+    Compare comp;
+    __list_entry_compare( Compare c ) : comp(c) {}
+    bool operator()( const Entry& x, const Entry& y ) const { return comp( x.key, y.key ); }
+};
+
+template <class Iterator, class Compare>
+struct __list_node_compare
+{
+    typedef typename Iterator::link_type link_type;
+    Compare comp;
+    __list_node_compare( Compare c ) : comp(c) {}
+    bool operator()( link_type x, link_type y ) const { return comp( *Iterator(x), *Iterator(y) ); }
+};
+
+// 依数组中的次序重新串接所有节点，一次走访
+template <class Link>
+void __list_relink( Link header, Link* first, Link* last )
+{
+    Link prev = header;
+    for( ; first != last; ++first )
+    {
+        prev->next = *first;
+        (*first)->prev = prev;
+        prev = *first;
+    }
+    prev->next = header;
+    header->prev = prev;
+}
+
+// 元素为POD且不大于两个指针时，收集时连同元素的副本，否则只收集节点指针
+template <class T>
+struct __list_gather_key
+{
+    typedef typename __type_traits<T>::is_POD_type is_POD;
+    typedef typename std::conditional<
+        std::is_same<is_POD, __true_type>::value && sizeof(T) <= 2 * sizeof(void*),
+        __true_type, __false_type>::type type;
+};
+
+// 小的POD元素：连同元素的副本一起收集，排序只在连续数组上进行
+template <class List, class Compare>
+void __list_gather_sort( List& l, Compare comp, __true_type )
+{
+    typedef typename List::iterator iterator;
+    typedef typename iterator::link_type link_type;
+    typedef __list_sort_entry<typename List::value_type, link_type> entry;
+    typedef simple_alloc<entry, malloc_alloc> entry_allocator;
+
+    size_t n = l.size();
+    entry* buf = entry_allocator::allocate( n );
+    entry* cur = buf;
+    for( iterator i = l.begin(); i != l.end(); ++i, ++cur )
+    {
+        cur->key = *i;
+        cur->node = i.node;
+    }
+    try
+    {
+        std::stable_sort( buf, buf + n, __list_entry_compare<entry, Compare>( comp ) );
+    }
+    catch(...)
+    {
+        entry_allocator::deallocate( buf, n );      // 尚未改动链接，list保持原样
+        throw;
+    }
+    // 节点指针就地挤到数组前段，entry至少与link_type一样大，不会覆盖尚未读取的项
+    link_type* nodes = reinterpret_cast<link_type*>( buf );
+    for( size_t i = 0; i < n; ++i )
+        nodes[i] = buf[i].node;
+    __list_relink( l.end().node, nodes, nodes + n );
+    entry_allocator::deallocate( buf, n );
+}
+
+// 其他元素：只收集节点指针，不复制元素
+template <class List, class Compare>
+void __list_gather_sort( List& l, Compare comp, __false_type )
+{
+    typedef typename List::iterator iterator;
+    typedef typename iterator::link_type link_type;
+    typedef simple_alloc<link_type, malloc_alloc> link_allocator;
+
+    size_t n = l.size();
+    link_type* buf = link_allocator::allocate( n );
+    link_type* cur = buf;
+    for( iterator i = l.begin(); i != l.end(); ++i, ++cur )
+        *cur = i.node;
+    try
+    {
+        std::stable_sort( buf, buf + n, __list_node_compare<iterator, Compare>( comp ) );
+    }
+    catch(...)
+    {
+        link_allocator::deallocate( buf, n );
+        throw;
+    }
+    __list_relink( l.end().node, buf, buf + n );
+    link_allocator::deallocate( buf, n );
+}
+
+// 稳定排序，相等的元素保持原来的先后次序
+template <class List, class Compare>
+void __list_sort( List& l, Compare comp )
+{
+    // size == 0 || size == 1 不用排序
+    if( l.size() < 2 )
+        return;
+    if( l.size() >= LYH_LIST_GATHER_SORT_MIN )
+    {
+        typedef typename __list_gather_key<typename List::value_type>::type with_key;
+        __list_gather_sort( l, comp, with_key() );
+    }
+    else
+        __list_counter_sort( l, comp );
+}
+
+template <class List>
+inline void __list_sort( List& l )
+{
+    __list_sort( l, __list_less<typename List::value_type>() );
+}
+
+// 并行排序时每一段至少有这么多个元素，元素太少时分段与调度的代价比排序本身还高
+#ifndef LYH_LIST_PARALLEL_SORT_MIN
+# define LYH_LIST_PARALLEL_SORT_MIN 32768
+#endif
+
+// 并行的稳定排序
+// 以splice把链表切成若干段，各段在任务池中同时排序，再两两merge成一棵树，
+// 全程只改动链接，不复制元素
+// 各段的链表头在调用线程中建立与销毁，任务中只用到__list_gather_sort(其缓冲区来自malloc)与splice，
+// 因此不会并发地使用非线程安全的次级配置器
+template <class List, class Compare>
+void __list_parallel_sort( List& l, Compare comp, thread_pool& pool )
+{
+    typedef typename List::iterator iterator;
+    typedef typename __list_gather_key<typename List::value_type>::type with_key;
+
+    size_t n = l.size();
+    size_t k = 4 * pool.size();                 // 段数多于线程数，让窃取平衡各段的快慢
+    if( k > n / LYH_LIST_PARALLEL_SORT_MIN )
+        k = n / LYH_LIST_PARALLEL_SORT_MIN;
+    if( k < 2 )
+    {
+        __list_sort( l, comp );
+        return;
+    }
+
+    std::unique_ptr<List[]> runs( new List[k] );
+    size_t len = n / k;
+    for( size_t i = 0; i + 1 < k; ++i )
+    {
+        iterator last = l.begin();
+        LYH::advance( last, len );
+        runs[i].splice( runs[i].end(), l, l.begin(), last );
+    }
+    runs[k - 1].splice( runs[k - 1].end(), l );
+
+    try
+    {
+        task_group group( pool );
+        for( size_t i = 0; i < k; ++i )
+        {
+            List* run = &runs[i];
+            group.run( [run, comp]{ __list_gather_sort( *run, comp, with_key() ); } );
+        }
+        group.wait();
+        // 两两合并，前一段的元素在前，保持稳定
+        for( size_t step = 1; step < k; step *= 2 )
+        {
+            for( size_t i = 0; i + step < k; i += 2 * step )
+            {
+                List* dst = &runs[i];
+                List* src = &runs[i + step];
+                group.run( [dst, src, comp]{ __list_merge( *dst, *src, comp ); } );
+            }
+            group.wait();
+        }
+    }
+    catch(...)
+    {
+        // comp抛出异常：元素全部接回l(次序不定)，不遗失任何节点
+        for( size_t i = 0; i < k; ++i )
+            l.splice( l.end(), runs[i] );
+        throw;
+    }
+    l.splice( l.end(), runs[0] );
+}
+
+// remove(value)使用的判断式
+template <class T>
+struct __list_equal_value
+{
+    const T& value;
+    explicit __list_equal_value( const T& v ) : value(v) {}
+    bool operator()( const T& x ) const { return x == value; }
+};
+
 // list结构设计
 // 只需要一个迭代器即可以表现
 // 刻意设置一个空节点,满足STL前闭后开原则
@@ -308,33 +894,137 @@ public:
 
 protected:
     link_type node;     // 只要一个指针,便可表示整个环状双向链表
-    // 配置一个节点并返回
-    link_type get_node() { return list_node_allocator::allocate(); }
-    // 释放一个节点
-    void put_node(link_type p ) { list_node_allocator::deallocate(p); }
+    size_type length;   // 元素个数，由insert、erase、clear、splice、merge维护，size()因此是O(1)
+
+    // 备用节点缓存：释放的节点先留在这里，下次配置时直接取用，不必经过配置器
+    // 队列式的用法(push_back与pop_front交替)在稳定状态下完全不碰配置器
+    // 备用节点以prev串成单向链，与free list格式相同，可以整串交还配置器
+    link_type spare;            // 备用链的头
+    size_type spare_count;      // 备用节点个数
+    size_type spare_limit;      // 备用节点个数的上限，0表示不缓存
+
+    // 配置一个节点并返回，优先取用备用节点
+    link_type get_node()
+    {
+        if( spare != 0 )
+        {
+            link_type p = spare;
+            spare = spare->prev;
+            --spare_count;
+            return p;
+        }
+        return list_node_allocator::allocate();
+    }
+    // 释放一个节点，备用链未满时留下备用
+    void put_node(link_type p )
+    {
+        if( spare_count < spare_limit )
+        {
+            p->prev = spare;
+            spare = p;
+            ++spare_count;
+            return;
+        }
+        list_node_allocator::deallocate(p);
+    }
+    // 备用节点只留下n个，其余交还配置器
+    void trim_spare( size_type n )
+    {
+        if( spare_count <= n )
+            return;
+        link_type head = spare;
+        link_type tail = 0;
+        for( ; spare_count > n; --spare_count )
+        {
+            tail = spare;
+            spare = spare->prev;
+        }
+        list_node_allocator::deallocate_chain( head, tail );
+    }
     // 产生(配置并构造)一个节点,带有元素值
     link_type create_node( const T& x )
     {
         link_type p = get_node();
-        construct( p, x );
+        construct( &p->data, x );
         return p;
     }
     // 销毁(析构并释放)一个节点
     void destroy_node(link_type p)
     {
-        destroy( p );
+        destroy( &p->data );
         put_node( p );
     }
 
 public:
     // ctor
-    list() { empty_initialize(); }
-    // 插入一个节点,作为尾节点
-    void push_back( const T& x )
-    { insert( end(), x ); }
-    // 插入一个节点,作为头节点
-    void push_front( const T& x )
-    { insert( begin(), x ); }
+    list() : spare(0), spare_count(0), spare_limit(0) { empty_initialize(); }
+    // 逐一复制元素，备用节点缓存属于各个list，不随之复制
+    list( const list& x ) : spare(0), spare_count(0), spare_limit(0)
+    {
+        empty_initialize();
+        try
+        {
+            for( link_type p = x.node->next; p != x.node; p = p->next )
+                insert( end(), p->data );
+        }
+        catch(...)
+        {
+            clear();
+            put_node( node );
+            throw;
+        }
+    }
+    // 先对既有节点逐一赋值，多出的节点移除，不足的再插入
+    // 节点尽量沿用，备用节点缓存与其上限保持不变
+    list& operator=( const list& x )
+    {
+        if( &x != this )
+        {
+            iterator first1 = begin();
+            iterator last1 = end();
+            link_type first2 = x.node->next;
+            for( ; first1 != last1 && first2 != x.node; ++first1, first2 = first2->next )
+                *first1 = first2->data;
+            if( first2 == x.node )
+                while( first1 != last1 )
+                    first1 = erase( first1 );
+            else
+                for( ; first2 != x.node; first2 = first2->next )
+                    insert( last1, first2->data );
+        }
+        return *this;
+    }
+    // dtor
+    ~list()
+    {
+        clear();
+        put_node( node );
+        trim_spare( 0 );
+    }
+
+    // 设定备用节点个数的上限，超出的备用节点立即交还配置器
+    void set_node_cache_limit( size_type n )
+    {
+        spare_limit = n;
+        trim_spare( n );
+    }
+    // 预先配置备用节点，使之后连续n次插入都不必经过配置器
+    // 上限随之至少提高到n
+    void reserve_nodes( size_type n )
+    {
+        if( spare_limit < n )
+            spare_limit = n;
+        while( spare_count < n )
+            put_node( list_node_allocator::allocate() );
+    }
+    // 目前的备用节点个数
+    size_type node_cache_size() const { return spare_count; }
+    // 插入一个节点,作为尾节点
+    void push_back( const T& x )
+    { insert( end(), x ); }
+    // 插入一个节点,作为头节点
+    void push_front( const T& x )
+    { insert( begin(), x ); }
 
 protected:
     void empty_initialize()
@@ -342,6 +1032,7 @@ protected:
         node = get_node();
         node->next = node;
         node->prev = node;
+        length = 0;
     }
     // 函数目的:在迭代器position所指位置插入一个节点,内容为x,返回指向新建节点的迭代器
     iterator insert( iterator position, const T& x )
@@ -350,21 +1041,19 @@ protected:
         // 调整指针
         tmp->next = position.node;
         tmp->prev = position.node->prev;
-        (link_type(position.node->prev))->next = tmp;
+        position.node->prev->next = tmp;
+        position.node->prev = tmp;
+        ++length;
         return tmp;
     }
 
 public:
-    iterator begin() { return (link_type)((*node).next); }
+    iterator begin() { return node->next; }
     iterator end() { return node; }
     bool empty() const
     { return node->next == node; }
     size_type size() const
-    {
-        size_type result = 0;
-        std::distance( begin(), end(), result );
-        return result;
-    }
+    { return length; }
     // 取头节点的内容
     reference front() { return *begin(); }
     // 取尾节点的内容
@@ -379,7 +1068,8 @@ public:
         prev_node->next = next_node;
         next_node->prev = prev_node;
         // 销毁节点
-        destroy_node( position );
+        destroy_node( position.node );
+        --length;
         return iterator(next_node);
     }
     // 移除头节点
@@ -387,35 +1077,70 @@ public:
     { erase( begin() ); }
     // 移除尾节点
     void pop_back()
-    { erase( end() ); }
+    {
+        iterator tmp = end();
+        erase( --tmp );
+    }
 
     // 清除所有节点(整个链表)
+    // 元素的dtor为trivial时不必走访链表：
+    // 每个节点的第一个字是prev，从尾节点沿prev往回本来就串成一条单向链，
+    // 正是配置器free list的格式，整串一次交还给配置器即可
+    // 备用链未满时，从尾节点起先补满备用链，其余的再整串交还
     void clear()
     {
-        link_type cur = (link_type) node->next;     // 开始节点
-        while( cur != node )
+        if( empty() )
+            return;
+        link_type first = node->next;     // 开始节点
+        link_type last = node->prev;      // 尾节点
+        destroy( begin(), end() );      // trivial dtor时什么都不做
+        while( spare_count < spare_limit && last != node )
         {
-            link_type tmp = cur;
-            cur = cur->next;
-            destroy_node( tmp );
+            link_type p = last;
+            last = last->prev;
+            put_node( p );
         }
+        if( last != node )
+            list_node_allocator::deallocate_chain( last, first );
         // 恢复node原始状态
         node->next = node;
         node->prev = node;
+        length = 0;
     }
 
     // 将数值为value的节点全部移除
+    // value可以是链表中某个元素的引用，节点在走访结束后才析构
     void remove( const T& value )
     {
-        iterator first = begin();
-        iterator last = end();
-        while( first != last )
-        {
-            iterator next = first;
-            ++next;
-            if( *first == value ) destroy_node( first );
-            first = next;
-        }
+        remove_if( __list_equal_value<T>( value ) );
+    }
+
+    // 将使pred为true的节点全部移除，传回移除的个数
+    // 走访时只把节点摘下，另外串成一条链，走访结束后才统一析构并交还配置器，
+    // 走访本身不夹杂配置器的操作；元素的dtor为trivial时整条链一次交还
+    template <class Predicate>
+    size_type remove_if( Predicate pred )
+    {
+        link_type head = 0;
+        link_type tail = 0;
+        size_type n = detach_if( pred, head, tail );
+        release_chain( head, tail );
+        return n;
+    }
+    // 同上，但析构与交还在任务池pool中进行，调用者不必等待
+    // 节点在另一个线程中交还，Alloc必须是线程安全的配置器(例如threaded_alloc)；
+    // 不经过备用节点缓存
+    template <class Predicate>
+    size_type remove_if( Predicate pred, thread_pool& pool )
+    {
+        static_assert( __alloc_thread_safe<Alloc>::value,
+                       "remove_if with a thread_pool requires a thread-safe allocator" );
+        link_type head = 0;
+        link_type tail = 0;
+        size_type n = detach_if( pred, head, tail );
+        if( head != 0 )
+            pool.post( [head, tail]{ list::release_detached( head, tail ); } );
+        return n;
     }
 
     // 移除数值相同的连续元素,"连续而相同的元素",才会被移除剩一个
@@ -424,9 +1149,11 @@ public:
         iterator first = begin();
         iterator last = end();
         if( first == last ) return;     // 空链表什么都不做
+        __list_prefetcher<iterator> pf( first, last );
         iterator next = first;
         while( ++next != last )
         {
+            pf.step();
             if( *first == *next )
                 erase(next);
             else
@@ -436,79 +1163,153 @@ public:
     }
 
 protected:
+    // 将使pred为true的节点摘下，以prev串成一条由head到tail的链(即free list的格式)，传回个数
+    // pred抛出异常时，已摘下的节点照常释放
+    template <class Predicate>
+    size_type detach_if( Predicate pred, link_type& head, link_type& tail )
+    {
+        size_type n = 0;
+        iterator first = begin();
+        iterator last = end();
+        __list_prefetcher<iterator> pf( first, last );
+        try
+        {
+            while( first != last )
+            {
+                link_type p = first.node;
+                ++first;
+                pf.step();
+                if( pred( p->data ) )
+                {
+                    p->prev->next = p->next;
+                    p->next->prev = p->prev;
+                    p->prev = head;
+                    head = p;
+                    if( tail == 0 )
+                        tail = p;
+                    ++n;
+                }
+            }
+        }
+        catch(...)
+        {
+            length -= n;
+            release_chain( head, tail );
+            throw;
+        }
+        length -= n;
+        return n;
+    }
+
+    // 析构一条以prev串接的节点链中的元素
+    static void destroy_chain( link_type, link_type, __true_type ) {}
+    static void destroy_chain( link_type head, link_type tail, __false_type )
+    {
+        for( ; ; head = head->prev )
+        {
+            destroy( &head->data );
+            if( head == tail )
+                break;
+        }
+    }
+    // 析构并整条交还配置器
+    static void release_detached( link_type head, link_type tail )
+    {
+        destroy_chain( head, tail, typename __type_traits<T>::has_trivial_destructor() );
+        list_node_allocator::deallocate_chain( head, tail );
+    }
+    // 析构后先补满备用链，其余的整条交还
+    void release_chain( link_type head, link_type tail )
+    {
+        if( head == 0 )
+            return;
+        destroy_chain( head, tail, typename __type_traits<T>::has_trivial_destructor() );
+        while( spare_count < spare_limit )
+        {
+            link_type p = head;
+            head = head->prev;
+            put_node( p );
+            if( p == tail )
+                return;
+        }
+        list_node_allocator::deallocate_chain( head, tail );
+    }
+
     // 将[first,last)内的所有元素移动到position之前
+    // 只调整链接，不维护length，由调用者负责
     void transfer( iterator position, iterator first, iterator last )
     {
         // 思路就是每变动一个指针,就会出现两个指针指向同一个节点情况,处理那个未变动的指针指向正确的位置
         // 分为向前处理与向后处理两个逻辑
-        if( position != last )
-        {
-            (*(link_type((*last.node).prev))).next = position.node;
-            (*link_type((*position.node).prev)).next = first.node;
-            (*link_type((*first.node).prev)).next = last.node;
-            link_type tmp = link_type((*position.node).prev);
-            (*position.node).prev = (*last.node).prev;
-            (*last.node).prev = (*first.node).prev;
-            (*first.node).prev = tmp;
-        }
+        __list_transfer( position.node, first.node, last.node );
     }
 
 public:
     // 接合操作
     // 将x结合于position所指位置之前,x必须不同于*this
+    // O(1)，元素个数整个转移
     void splice( iterator position, list& x )
     {
         if( !x.empty() )
+        {
             transfer( position, x.begin(), x.end() );
+            length += x.length;
+            x.length = 0;
+        }
     }
 
     // 将i所指元素接合于position所指位置之前,position和i可能指向同一个list
-    void splice( iterator position, list&, iterator i )
+    // O(1)
+    void splice( iterator position, list& x, iterator i )
     {
         iterator j = i;
         ++j;
         if( position == i || position == j ) return;    // 要么已经在前面了,要么是插入位置是它自身
         transfer( position, i, j );
+        --x.length;
+        ++length;
     }
 
     // 将[first,last)内的所有元素接合于position所指之前
     // position和区间可能在同一list中
     // 但position不能在区间中
-    void splice( iterator position, list&, iterator first, iterator last )
+    // 同一list内是O(1)；区间来自另一个list时，须先数出区间内的元素个数，代价O(区间长度)
+    void splice( iterator position, list& x, iterator first, iterator last )
     {
         if( first != last )
+        {
+            if( &x != this )
+            {
+                size_type n = 0;
+                for( iterator i = first; i != last; ++i )
+                    ++n;
+                x.length -= n;
+                length += n;
+            }
             transfer( position, first, last );
+        }
     }
 
     // 将x合并到*this上,两个list必须都已经过递增排序
+    // 相等的元素，*this的在前
     void merge( list& x )
     {
-        iterator first1 = begin();
-        iterator last1 = end();
-        iterator first2 = x.begin();
-        iterator last2 = x.end();
-
-        while( first1 != last1 && first2 != last2 )
-        {
-            if( *first1 < *first2 )
-            {
-                iterator next = first2;
-                transfer( first1, first2, ++next );
-                first2 = next;
-            }
-            else
-                ++first1;
-            if( first2 != last2 )       // TODO
-                transfer( last1, first2, last2 );
-        }
+        __list_merge( *this, x );
+    }
+    // 以comp代替operator<
+    template <class Compare>
+    void merge( list& x, Compare comp )
+    {
+        __list_merge( *this, x, comp );
     }
     // reverse()将*this的内容逆向重置
     void reverse()
     {
         // size == 0 || size == 1 不用翻转
-        if( node->next == node || link_type(node->next)->next == node )
+        if( node->next == node || node->next->next == node )
             return;
         iterator first = begin();
+        ++first;        // 第一个节点不动，其后的节点逐个移到最前面
         while( first != end() )
         {
             iterator old = first;
@@ -518,245 +1319,2264 @@ public:
     }
     // STL算法只接受RamadanAccessIterator
     // 所以list需要自己的sort()
-    // 快排思路
+    // 稳定的合并排序，见__list_sort
     void sort()
     {
-        // size == 0 || size == 1 不用排序
-        if( node->next == node || link_type(node->next)->next == node )
-            return;
-        // 申请一些新的空间,作为中介数据存放
-        list<T,Alloc> carry;
-        list<T,Alloc> counter[64];
-        int fill = 0;
-        while( !empty() )
-        {
-            carry.splice( carry.begin(), *this, begin() );
-            int i = 0;
-            while( i < fill && !counter[i].empty() )
-            {
-                counter[i].merge( carry );
-                carry.swap( counter[i++] );
-            }
-            carry.swap( counter[i] );
-            if( i == fill ) fill++;
-        }
-        for( int i = 1; i < fill; ++i )
-            counter[i].merge( counter[i-1] );
-        std::swap( counter[fill - 1] );
+        __list_sort( *this );
+    }
+    template <class Compare>
+    void sort( Compare comp )
+    {
+        __list_sort( *this, comp );
+    }
+    // 在任务池pool中并行排序，见__list_parallel_sort
+    void sort( thread_pool& pool )
+    {
+        __list_parallel_sort( *this, __list_less<T>(), pool );
+    }
+    template <class Compare>
+    void sort( thread_pool& pool, Compare comp )
+    {
+        __list_parallel_sort( *this, comp, pool );
+    }
+
+    // 交换两个list，只需交换头节点与元素个数
+    void swap( list& x )
+    {
+        std::swap( node, x.node );
+        std::swap( length, x.length );
     }
 };
 
-// 设置缓冲区的大小
-// 传入BufSiz(元素个数),元素大小,传回元素个数
-// 处理默认情况BufSiz为0的情况
-// 如果n不为0,传回n,表示buffer size 是用户自定义的
-// 如果n为0,表示buffer size使用默认值,那么
-// 如果sz(元素大小)小于512/sz
-// 如果sz不小于512,传回1
-inline size_t __deque_buf_size( size_t n, size_t sz )
+// 移除l中使pred为true的元素，传回移除的个数
+template <class T, class Alloc, class Predicate>
+inline typename list<T, Alloc>::size_type erase_if( list<T, Alloc>& l, Predicate pred )
 {
-    return n != 0 ? n : ( sz < 512 ? size_t( 512/sz ) : size_t(1) );
+    return l.remove_if( pred );
 }
 
-// deque需要知道缓冲区的大小
-template <class T, class Ref, class Ptr, size_t BufSiz>
-struct __deque_iterator // 未继承std::iterator
+// 侵入式链表的挂钩，即__list_node中的prev、next
+// 用户的型别以它为基类，把链接嵌入对象本身；Tag用来区分同一对象上的多个挂钩
+// (例如同时挂在LRU链与计时轮上)
+template <class Tag = void>
+struct list_hook
+{
+    list_hook* prev;
+    list_hook* next;
+
+    list_hook() : prev(0), next(0) {}
+    // 复制对象时不复制链接，新对象不在任何链表中
+    list_hook( const list_hook& ) : prev(0), next(0) {}
+    list_hook& operator=( const list_hook& ) { return *this; }
+    // 是否挂在某个链表上
+    bool is_linked() const { return next != 0; }
+};
+
+// 侵入式链表的迭代器，挂钩与对象之间以static_cast转换
+template <class T, class Ref, class Ptr, class Tag>
+struct __intrusive_list_iterator
 {
-    typedef __deque_iterator<T, T&, T*, BufSiz> iterator;
-    typedef __deque_iterator<T, T&, const T*, BufSiz> const_iterator;
-    static size_t buffer_size() { return __deque_buf_size(BufSiz, sizeof(T)); }
+    typedef __intrusive_list_iterator<T, T&, T*, Tag> iterator;
+    typedef __intrusive_list_iterator<T, Ref, Ptr, Tag> self;
 
-    typedef std::random_access_iterator_tag iterator_category;
+    typedef bidirectional_iterator_tag iterator_category;
     typedef T value_type;
     typedef Ptr pointer;
     typedef Ref reference;
+    typedef list_hook<Tag>* link_type;
     typedef size_t size_type;
     typedef ptrdiff_t difference_type;
-    // 与容器联系
-    typedef T** map_pointer;
-
-    typedef __deque_iterator self;
 
-    // 成员(与容器联接)
-    T* cur;         // 此迭代器所指之缓冲区中的现行元素
-    T* first;       // 此迭代器所指之缓冲区的头
-    T* last;        // 此迭代器所指之缓冲区的尾(含备用空间)
-    map_pointer node;   // 指向管控中心(中控器)
-                        // 可以理解为deque的map的下标
+    link_type node;
 
-    // 行为
-    // 跳转至下一个缓冲区
-    void set_node( map_pointer new_node)
-    {
-        node = new_node;
-        first = *new_node;
-        last = first + difference_type( buffer_size() );
-    }
-    // 重载运算符
-    reference operator*() const { return *cur; }
-    pointer operator->() const { return &(operator*()); }
+    // ctor
+    __intrusive_list_iterator( link_type x ) : node(x) {}
+    __intrusive_list_iterator() {}
+    // iterator转为const_iterator；复制构造与赋值都由编译器产生
+    template <class R, class P>
+    __intrusive_list_iterator( const __intrusive_list_iterator<T, R, P, Tag>& x,
+                               typename std::enable_if<std::is_same<R, T&>::value>::type* = 0 ) : node(x.node) {}
 
-    difference_type operator-( const self& x ) const
-    {
-        // 计算思路:
-        // 如 1--2--3--4--5
-        // this在1,x在5
-        // 2.3.4是完整的,乘以缓冲区大小
-        // 再分别计算1中与5中的位置差距
-        return difference_type(buffer_size()) * ( node - x.node - 1 ) + ( cur - first ) + ( x.last - x.cur );
-    }
-    // 前置加加
+    bool operator==( const self& x ) const
+    { return node == x.node; }
+    bool operator!=( const self& x ) const
+    { return node != x.node; }
+    reference operator*() const
+    { return static_cast<reference>( *node ); }
+    pointer operator->() const
+    { return &(operator*()); }
     self& operator++()
     {
-        ++cur;
-        if( cur == last )
-        {
-            set_node( node+1 );
-            cur = first;
-        }
+        node = node->next;
         return *this;
     }
-    // 后置加加
     self operator++(int)
     {
-        self tmp = cur;
+        self ret = *this;
         ++*this;
-        return tmp;
+        return ret;
     }
-    // 前置--
     self& operator--()
     {
-        if( cur = first )
-        {
-            set_node( node - 1 );
-            cur = last;
-        }
-        --cur;
+        node = node->prev;
         return *this;
     }
-    // 后置--
     self operator--(int)
     {
-        self tmp = cur;
+        self ret = *this;
         --*this;
-        return tmp;
-    }
-    // 实现随机存取,迭代器可以直接跳跃n个距离
-    self& operator+=( difference_type n )
-    {
-        difference_type offset = n + ( cur - first );
-        if( offset >= 0 && offset < difference_type( buffer_size() ))
-            // 在同一个缓冲区
-            cur += n;
-        else
-        {
-            // 不在同一个缓冲区
-            difference_type node_offset =
-                    offset > 0 ? offset / difference_type( buffer_size() ) : -difference_type( ( ( -offset - 1 ) / buffer_size() ) ) - 1;
-            // 切换至正确的缓冲区
-            set_node( node + node_offset );
-            // 切换至正确的元素
-            cur = first + ( offset - node_offset * ( difference_type( buffer_size() ) ) );
-        }
-    }
-    self operator+( difference_type n )const
-    {
-        self tmp = this;
-        return tmp += n;
-    }
-    self& operator-=( difference_type n )
-    {
-        return *this += -n;
-    }
-    self operator-( difference_type n ) const
-    {
-        self tmp = *this;
-        return tmp -= n;
-    }
-
-    reference operator[]( difference_type n ) const
-    {
-        return *( *this + n );
+        return ret;
     }
-
-    bool operator==( const self& x ) const { return cur == x.cur; }
-    bool operator!=( const self& x ) const { return cur != x.cur; }
-    bool operator< ( const self& x ) const { return ( node == x.node ) ? ( cur < x.cur ) : ( node < x.node ) ; }
 };
 
-
-// BufSiz 指出缓冲区的大小
-// deque 可以理解为维护一个数组的数组
-// deque需要两个自带迭代器,指出首末元素
-template <class T, class Alloc = alloc, size_t BufSiz = 0>
-class deque
+// 侵入式链表
+// 不配置、不构造、不析构任何东西：对象的生命期由用户管理(例如放在内存池中)，
+// 链表只负责挂上与取下；接合、合并、排序与list共用同一套算法
+// 一个对象同一时间只能挂在一条使用同一Tag的链表上
+template <class T, class Tag = void>
+class intrusive_list
 {
 public:
-    // 内嵌型定义
-    typedef T                    value_type;
-    typedef value_type*          pointer;
-    typedef __deque_iterator<T, T&, T*, BufSiz> iterator;
-    typedef value_type&          reference;
-    typedef const value_type&    const_reference;
-    typedef size_t               size_type;
-    typedef ptrdiff_t            difference_type;
-
-protected:
-    // 内部定义
-    // 元素的指针的指针
-    // 即指向map的空间
-    typedef pointer* map_pointer;
-
-protected:
-    // 成员
-    map_pointer map;        // 指向map,map是一片连续的空间,每个元素是一个指针,指向一块缓冲区
-    size_type map_size;     // map内有多少指针,即deque有多少个二级数组
-    iterator start;         // 表现第一个
-    iterator finish;        // 表现最后一个节点
+    typedef list_hook<Tag>      hook_type;
+    typedef hook_type*          link_type;
+    typedef __intrusive_list_iterator<T, T&, T*, Tag> iterator;
+    typedef size_t              size_type;
+    typedef T                   value_type;
+    typedef T&                  reference;
+    typedef T*                  pointer;
 
 protected:
-    // 专属空间配置器,每次配置一个元素大小
-    typedef simple_alloc<value_type, Alloc> data_allocator;
-    // 专属空间配置器,每次配置一个指针大小
-    typedef simple_alloc<pointer, Alloc> map_allocator;
+    hook_type node;         // 内嵌的头节点
+    size_type length;       // 元素个数
 
-public:
-    // 构造
-    deque( int n, const value_type & value )
-    : start(), finish(),map(0), map_size(0)
+    void empty_initialize()
     {
-        fill_initialize( n, value );
+        node.next = &node;
+        node.prev = &node;
+        length = 0;
     }
-    void fill_initialize( size_type n, const value_type& value )
+    void transfer( iterator position, iterator first, iterator last )
     {
-        creat_map_and_nodes(n);
-        map_pointer cur;
-        for( cur = start.node; cur < finish.node; ++cur )
-            std::uninitialized_fill( *cur, *cur + buffer_size(), value );
+        __list_transfer( position.node, first.node, last.node );
     }
 
+private:
+    // 对象不能同时挂在两条链表上，因此不能复制
+    intrusive_list( const intrusive_list& );
+    intrusive_list& operator=( const intrusive_list& );
+
 public:
-    // 基础数据行为
-    iterator begin() { return start; }
-    iterator end() { return finish; }
+    // ctor
+    intrusive_list() { empty_initialize(); }
+    // dtor，只把对象取下
+    ~intrusive_list() { clear(); }
 
-    reference operator[]( size_type n )
+    iterator begin() { return node.next; }
+    iterator end() { return &node; }
+    bool empty() const { return node.next == &node; }
+    size_type size() const { return length; }
+    reference front() { return *begin(); }
+    reference back() { return *(--end()); }
+    // 由对象直接得到迭代器，O(1)，例如LRU中把命中的对象移到最前面
+    static iterator iterator_to( reference x ) { return iterator( static_cast<link_type>( &x ) ); }
+
+    // 将x挂在position之前，x不能已在链表中
+    iterator insert( iterator position, reference x )
     {
-        return start[difference_type(n)];
+        link_type tmp = static_cast<link_type>( &x );
+        tmp->next = position.node;
+        tmp->prev = position.node->prev;
+        position.node->prev->next = tmp;
+        position.node->prev = tmp;
+        ++length;
+        return tmp;
     }
+    void push_back( reference x ) { insert( end(), x ); }
+    void push_front( reference x ) { insert( begin(), x ); }
 
-    reference front() { return *start; }
-    reference back()
+    // 取下迭代器所指对象，传回下一个对象的迭代器
+    iterator erase( iterator position )
+    {
+        link_type next_node = position.node->next;
+        link_type prev_node = position.node->prev;
+        prev_node->next = next_node;
+        next_node->prev = prev_node;
+        position.node->prev = position.node->next = 0;
+        --length;
+        return iterator( next_node );
+    }
+    void pop_front() { erase( begin() ); }
+    void pop_back()
+    {
+        iterator tmp = end();
+        erase( --tmp );
+    }
+    // 取下所有对象，逐个清除挂钩以便is_linked()正确
+    void clear()
+    {
+        link_type cur = node.next;
+        while( cur != &node )
+        {
+            link_type tmp = cur;
+            cur = cur->next;
+            tmp->prev = tmp->next = 0;
+        }
+        empty_initialize();
+    }
+
+    // 取下数值为value的对象
+    void remove( const T& value )
+    {
+        iterator first = begin();
+        iterator last = end();
+        while( first != last )
+        {
+            iterator next = first;
+            ++next;
+            if( *first == value ) erase( first );
+            first = next;
+        }
+    }
+    // 取下数值相同的连续对象，只留一个
+    void unique()
+    {
+        iterator first = begin();
+        iterator last = end();
+        if( first == last ) return;
+        iterator next = first;
+        while( ++next != last )
+        {
+            if( *first == *next )
+                erase( next );
+            else
+                first = next;
+            next = first;
+        }
+    }
+
+    // 接合操作，与list相同
+    void splice( iterator position, intrusive_list& x )
+    {
+        if( !x.empty() )
+        {
+            transfer( position, x.begin(), x.end() );
+            length += x.length;
+            x.length = 0;
+        }
+    }
+    void splice( iterator position, intrusive_list& x, iterator i )
+    {
+        iterator j = i;
+        ++j;
+        if( position == i || position == j ) return;
+        transfer( position, i, j );
+        --x.length;
+        ++length;
+    }
+    // 区间来自另一条链表时，须先数出区间内的元素个数，代价O(区间长度)
+    void splice( iterator position, intrusive_list& x, iterator first, iterator last )
+    {
+        if( first != last )
+        {
+            if( &x != this )
+            {
+                size_type n = 0;
+                for( iterator i = first; i != last; ++i )
+                    ++n;
+                x.length -= n;
+                length += n;
+            }
+            transfer( position, first, last );
+        }
+    }
+
+    void merge( intrusive_list& x ) { __list_merge( *this, x ); }
+    template <class Compare>
+    void merge( intrusive_list& x, Compare comp ) { __list_merge( *this, x, comp ); }
+    void sort() { __list_sort( *this ); }
+    template <class Compare>
+    void sort( Compare comp ) { __list_sort( *this, comp ); }
+    void sort( thread_pool& pool ) { __list_parallel_sort( *this, __list_less<T>(), pool ); }
+    template <class Compare>
+    void sort( thread_pool& pool, Compare comp ) { __list_parallel_sort( *this, comp, pool ); }
+    void reverse()
+    {
+        if( length < 2 )
+            return;
+        iterator first = begin();
+        ++first;
+        while( first != end() )
+        {
+            iterator old = first;
+            ++first;
+            transfer( begin(), old, first );
+        }
+    }
+
+    // 交换两条链表，内嵌头节点的前后节点要重新指回来
+    void swap( intrusive_list& x )
+    {
+        std::swap( node.prev, x.node.prev );
+        std::swap( node.next, x.node.next );
+        std::swap( length, x.length );
+        if( node.next == &x.node )
+            node.next = node.prev = &node;
+        else
+            node.next->prev = node.prev->next = &node;
+        if( x.node.next == &node )
+            x.node.next = x.node.prev = &x.node;
+        else
+            x.node.next->prev = x.node.prev->next = &x.node;
+    }
+};
+
+// unrolled list(展开链表)
+// 每个节点存放一段连续的元素,而非一个元素,走访时大部分是连续的内存访问
+
+// 每个节点可容纳的元素个数
+// 如果n不为0,传回n,表示由用户自定义
+// 如果n为0,使整个节点(两个链接、一个计数与所有元素)不超过__UNROLLED_NODE_BYTES,
+// 即两条cache line,同时也落在内存池的管辖范围内;至少容纳1个元素
+enum { __UNROLLED_NODE_BYTES = 128 };
+inline constexpr size_t __unrolled_node_capacity( size_t n, size_t sz )
+{
+    return n != 0 ? n :
+           ( sz + 3 * sizeof(void*) < size_t( __UNROLLED_NODE_BYTES ) ?
+             ( size_t( __UNROLLED_NODE_BYTES ) - 3 * sizeof(void*) ) / sz : size_t(1) );
+}
+
+// 节点的链接部分,unrolled_list内嵌的头节点只有这一部分
+// prev必须是第一个成员:clear()将节点沿prev串成的链直接交还给配置器
+struct __unrolled_node_base
+{
+    __unrolled_node_base* prev;
+    __unrolled_node_base* next;
+};
+
+// 节点:元素放在[data(), data() + count)内,除头节点外每个节点至少有一个元素
+template <class T, size_t Cap>
+struct __unrolled_node : public __unrolled_node_base
+{
+    size_t count;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buf[Cap];
+    T* data() { return reinterpret_cast<T*>( buf ); }
+};
+
+// 迭代器:所在节点与节点内的下标
+// end()为头节点、下标0
+template <class T, class Ref, class Ptr, size_t Cap>
+struct __unrolled_list_iterator
+{
+    typedef __unrolled_list_iterator<T, T&, T*, Cap> iterator;
+    typedef __unrolled_list_iterator<T, Ref, Ptr, Cap> self;
+
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef __unrolled_node<T, Cap>* link_type;
+    typedef __unrolled_node_base* base_ptr;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    base_ptr node;      // 所在节点
+    size_t index;       // 节点内的下标
+
+    // ctor
+    __unrolled_list_iterator( base_ptr x, size_t i ) : node(x), index(i) {}
+    __unrolled_list_iterator() {}
+    // iterator转为const_iterator；复制构造与赋值都由编译器产生
+    template <class R, class P>
+    __unrolled_list_iterator( const __unrolled_list_iterator<T, R, P, Cap>& x,
+                              typename std::enable_if<std::is_same<R, T&>::value>::type* = 0 ) : node(x.node), index(x.index) {}
+
+    bool operator==( const self& x ) const
+    { return node == x.node && index == x.index; }
+    bool operator!=( const self& x ) const
+    { return !( *this == x ); }
+    reference operator*() const
+    { return static_cast<link_type>( node )->data()[index]; }
+    pointer operator->() const
+    { return &(operator*()); }
+    // 在节点内前进,走完一个节点才跳到下一个节点
+    self& operator++()
+    {
+        if( ++index == static_cast<link_type>( node )->count )
+        {
+            node = node->next;
+            index = 0;
+        }
+        return *this;
+    }
+    self operator++(int)
+    {
+        self ret = *this;
+        ++*this;
+        return ret;
+    }
+    self& operator--()
+    {
+        if( index == 0 )
+        {
+            node = node->prev;
+            index = static_cast<link_type>( node )->count;
+        }
+        --index;
+        return *this;
+    }
+    self operator--(int)
+    {
+        self ret = *this;
+        --*this;
+        return ret;
+    }
+};
+
+// unrolled_list结构设计
+// 接口与list相同;K指出每个节点容纳的元素个数,0表示以节点大小为准
+// 与list不同之处:
+// 1. 元素在节点内以复制的方式搬动,插入、删除以及非节点边界处的接合会使同一节点内的迭代器失效
+// 2. 接合在节点边界上是O(1);区间不在边界上时先分裂节点,代价O(K)
+template <class T, class Alloc = alloc, size_t K = 0>
+class unrolled_list
+{
+public:
+    enum { node_capacity = __unrolled_node_capacity( K, sizeof(T) ) };
+
+protected:
+    typedef __unrolled_node<T, node_capacity> list_node;
+    typedef __unrolled_node_base* base_ptr;
+    // 专属空间配置器,每次配置一个节点大小
+    typedef simple_alloc<list_node, Alloc> list_node_allocator;
+
+public:
+    typedef list_node*      link_type;
+    typedef __unrolled_list_iterator<T, T&, T*, node_capacity> iterator;
+    typedef size_t          size_type;
+    typedef T               value_type;
+    typedef T&              reference;
+    typedef T*              pointer;
+
+protected:
+    __unrolled_node_base header;    // 内嵌的头节点,不存放元素
+    size_type length;               // 元素个数
+
+    link_type get_node()
+    {
+        link_type p = list_node_allocator::allocate();
+        p->count = 0;
+        return p;
+    }
+    void put_node( base_ptr p ) { list_node_allocator::deallocate( static_cast<link_type>( p ) ); }
+    // 将节点n接在position之前
+    static void link_before( base_ptr position, base_ptr n )
+    {
+        n->next = position;
+        n->prev = position->prev;
+        position->prev->next = n;
+        position->prev = n;
+    }
+    static void unlink( base_ptr n )
+    {
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+    }
+    void empty_initialize()
+    {
+        header.next = &header;
+        header.prev = &header;
+        length = 0;
+    }
+    // 在节点p的下标i处插入x,p必须还有空间
+    static void insert_into_node( link_type p, size_t i, const T& x )
+    {
+        T* d = p->data();
+        if( i == p->count )
+            construct( d + i, x );
+        else
+        {
+            T x_copy = x;
+            construct( d + p->count, d[p->count - 1] );
+            LYH::copy_backward( d + i, d + p->count - 1, d + p->count );
+            d[i] = x_copy;
+        }
+        ++p->count;
+    }
+    // 使position成为节点的起点,传回该节点
+    // 原节点中position及其后的元素搬到新节点;fix1、fix2若指向被搬走的元素,一并调整
+    base_ptr split( iterator position, iterator* fix1 = 0, iterator* fix2 = 0 )
+    {
+        if( position.index == 0 )
+            return position.node;       // 已是节点起点(含end())
+        link_type p = static_cast<link_type>( position.node );
+        const size_t k = position.index;
+        if( k == p->count )
+            return p->next;
+        link_type q = get_node();
+        try
+        {
+            LYH::uninitialized_copy( p->data() + k, p->data() + p->count, q->data() );
+        }
+        catch(...)
+        {
+            put_node( q );
+            throw;
+        }
+        destroy( p->data() + k, p->data() + p->count );
+        q->count = p->count - k;
+        p->count = k;
+        link_before( p->next, q );
+        if( fix1 && fix1->node == p && fix1->index >= k )
+            *fix1 = iterator( q, fix1->index - k );
+        if( fix2 && fix2->node == p && fix2->index >= k )
+            *fix2 = iterator( q, fix2->index - k );
+        return q;
+    }
+    // 将节点区间[first,last)移动到position之前,与list::transfer相同
+    static void transfer( base_ptr position, base_ptr first, base_ptr last )
+    {
+        if( position != last )
+        {
+            last->prev->next = position;
+            position->prev->next = first;
+            first->prev->next = last;
+            base_ptr tmp = position->prev;
+            position->prev = last->prev;
+            last->prev = first->prev;
+            first->prev = tmp;
+        }
+    }
+    // 节点p的元素全部放得进前一个节点时,并入前一个节点并释放p,传回元素现在所在的节点
+    // 用于remove()、unique()之后维持节点的密度
+    link_type coalesce_with_prev( link_type p )
+    {
+        if( p->prev == &header )
+            return p;
+        link_type q = static_cast<link_type>( p->prev );
+        if( q->count + p->count > size_t( node_capacity ) )
+            return p;
+        LYH::uninitialized_copy( p->data(), p->data() + p->count, q->data() + q->count );
+        destroy( p->data(), p->data() + p->count );
+        q->count += p->count;
+        unlink( p );
+        put_node( p );
+        return q;
+    }
+    // 输出节点已满时取一个空节点接在尾端:先用回收的节点,没有才向配置器申请
+    link_type next_output_node( base_ptr& spare )
+    {
+        link_type out;
+        if( spare )
+        {
+            out = static_cast<link_type>( spare );
+            spare = spare->next;
+            out->count = 0;
+        }
+        else
+            out = get_node();
+        link_before( &header, out );
+        return out;
+    }
+    // merge()抛出异常时,把取下的节点链n余下的部分接回尾端
+    // 链的第一个节点前idx个元素已经移出,其余元素逐个搬到节点开头;搬动时再抛出异常,这个节点余下的元素只能放弃
+    void relink_chain( base_ptr n, size_t idx )
+    {
+        while( n )
+        {
+            link_type p = static_cast<link_type>( n );
+            n = n->next;
+            if( idx != 0 )
+            {
+                T* d = p->data();
+                size_t j = 0;
+                try
+                {
+                    for( ; idx + j < p->count; ++j )
+                    {
+                        construct( d + j, d[idx + j] );
+                        destroy( d + idx + j );
+                    }
+                }
+                catch(...)
+                {
+                    destroy( d + idx + j, d + p->count );
+                }
+                p->count = j;
+                idx = 0;
+            }
+            if( p->count == 0 )
+                put_node( p );
+            else
+                link_before( &header, p );
+        }
+    }
+
+public:
+    // ctor
+    unrolled_list() { empty_initialize(); }
+    // 逐个节点复制;复制失败时已复制的节点全部释放
+    unrolled_list( const unrolled_list& x )
+    {
+        empty_initialize();
+        try
+        {
+            for( base_ptr n = x.header.next; n != &x.header; n = n->next )
+            {
+                link_type src = static_cast<link_type>( n );
+                link_type p = get_node();
+                try
+                {
+                    LYH::uninitialized_copy( src->data(), src->data() + src->count, p->data() );
+                }
+                catch(...)
+                {
+                    put_node( p );
+                    throw;
+                }
+                p->count = src->count;
+                link_before( &header, p );
+                length += p->count;
+            }
+        }
+        catch(...)
+        {
+            clear();
+            throw;
+        }
+    }
+    unrolled_list& operator=( const unrolled_list& x )
+    {
+        if( &x != this )
+        {
+            unrolled_list tmp( x );
+            swap( tmp );
+        }
+        return *this;
+    }
+    // dtor
+    ~unrolled_list() { clear(); }
+
+    iterator begin() { return iterator( header.next, 0 ); }
+    iterator end() { return iterator( &header, 0 ); }
+    bool empty() const { return length == 0; }
+    size_type size() const { return length; }
+    // 取头元素的内容
+    reference front() { return static_cast<link_type>( header.next )->data()[0]; }
+    // 取尾元素的内容
+    reference back()
+    {
+        link_type p = static_cast<link_type>( header.prev );
+        return p->data()[p->count - 1];
+    }
+
+    // 在position之前插入x,传回指向新元素的迭代器
+    // 所在节点已满时分裂为两半
+    // 元素构造成功之后才计入length
+    iterator insert( iterator position, const T& x )
+    {
+        if( position.node == &header )
+        {
+            // 插在尾端,尾节点还有空间就直接放入
+            base_ptr last = header.prev;
+            if( last != &header && static_cast<link_type>( last )->count < size_t( node_capacity ) )
+            {
+                link_type p = static_cast<link_type>( last );
+                construct( p->data() + p->count, x );
+                ++p->count;
+                ++length;
+                return iterator( p, p->count - 1 );
+            }
+            link_type tmp = get_node();
+            try
+            {
+                construct( tmp->data(), x );
+            }
+            catch(...)
+            {
+                put_node( tmp );
+                throw;
+            }
+            tmp->count = 1;
+            link_before( &header, tmp );
+            ++length;
+            return iterator( tmp, 0 );
+        }
+        link_type p = static_cast<link_type>( position.node );
+        size_t i = position.index;
+        if( p->count == size_t( node_capacity ) )
+        {
+            // 节点已满,后一半搬到新节点
+            T x_copy = x;
+            const size_t half = size_t( node_capacity ) / 2;
+            link_type q = get_node();
+            try
+            {
+                LYH::uninitialized_copy( p->data() + half, p->data() + p->count, q->data() );
+            }
+            catch(...)
+            {
+                put_node( q );
+                throw;
+            }
+            destroy( p->data() + half, p->data() + p->count );
+            q->count = p->count - half;
+            p->count = half;
+            link_before( p->next, q );
+            if( i > half )
+            {
+                p = q;
+                i -= half;
+            }
+            insert_into_node( p, i, x_copy );
+            ++length;
+            return iterator( p, i );
+        }
+        insert_into_node( p, i, x );
+        ++length;
+        return iterator( p, i );
+    }
+    // 插入一个元素,作为尾元素
+    void push_back( const T& x ) { insert( end(), x ); }
+    // 插入一个元素,作为头元素
+    void push_front( const T& x ) { insert( begin(), x ); }
+
+    // 移除迭代器所指元素,传回下一个元素的迭代器
+    // 节点被取空时释放节点
+    iterator erase( iterator position )
+    {
+        link_type p = static_cast<link_type>( position.node );
+        const size_t i = position.index;
+        LYH::copy( p->data() + i + 1, p->data() + p->count, p->data() + i );
+        --p->count;
+        destroy( p->data() + p->count );
+        --length;
+        if( p->count == 0 )
+        {
+            base_ptr next = p->next;
+            unlink( p );
+            put_node( p );
+            return iterator( next, 0 );
+        }
+        if( i == p->count )
+            return iterator( p->next, 0 );
+        return iterator( p, i );
+    }
+    // 移除头元素
+    void pop_front() { erase( begin() ); }
+    // 移除尾元素
+    void pop_back()
+    {
+        iterator tmp = end();
+        erase( --tmp );
+    }
+
+    // 清除所有元素
+    // 节点的第一个字是prev,与list::clear()相同,整串一次交还给配置器
+    void clear()
+    {
+        if( header.next == &header )
+            return;
+        for( base_ptr n = header.next; n != &header; n = n->next )
+        {
+            link_type p = static_cast<link_type>( n );
+            destroy( p->data(), p->data() + p->count );     // trivial dtor时什么都不做
+        }
+        list_node_allocator::deallocate_chain( static_cast<link_type>( header.prev ),
+                                               static_cast<link_type>( header.next ) );
+        empty_initialize();
+    }
+
+    // 将数值为value的元素全部移除
+    // 每个节点就地压实,取空的节点释放,放得进前一个节点的并入前一个节点
+    void remove( const T& value )
+    {
+        const T value_copy = value;     // value可能就是链表中的元素
+        base_ptr n = header.next;
+        while( n != &header )
+        {
+            link_type p = static_cast<link_type>( n );
+            base_ptr next = n->next;
+            T* d = p->data();
+            size_t w = 0;
+            for( size_t r = 0; r < p->count; ++r )
+            {
+                if( !( d[r] == value_copy ) )
+                {
+                    if( w != r )
+                        d[w] = d[r];
+                    ++w;
+                }
+            }
+            destroy( d + w, d + p->count );
+            length -= p->count - w;
+            p->count = w;
+            if( w == 0 )
+            {
+                unlink( p );
+                put_node( p );
+            }
+            else
+                coalesce_with_prev( p );
+            n = next;
+        }
+    }
+
+    // 移除数值相同的连续元素,只剩一个
+    void unique()
+    {
+        if( length < 2 )
+            return;
+        base_ptr n = header.next;
+        while( n != &header )
+        {
+            link_type p = static_cast<link_type>( n );
+            base_ptr next = n->next;
+            // 上一个保留下来的元素,即前一个节点的尾元素
+            T* kept = 0;
+            if( p->prev != &header )
+            {
+                link_type q = static_cast<link_type>( p->prev );
+                kept = q->data() + q->count - 1;
+            }
+            T* d = p->data();
+            size_t w = 0;
+            for( size_t r = 0; r < p->count; ++r )
+            {
+                if( kept && *kept == d[r] )
+                    continue;
+                if( w != r )
+                    d[w] = d[r];
+                kept = d + w;
+                ++w;
+            }
+            destroy( d + w, d + p->count );
+            length -= p->count - w;
+            p->count = w;
+            if( w == 0 )
+            {
+                unlink( p );
+                put_node( p );
+            }
+            else
+                coalesce_with_prev( p );
+            n = next;
+        }
+    }
+
+    // 接合操作
+    // 将x结合于position所指位置之前,x必须不同于*this
+    void splice( iterator position, unrolled_list& x )
+    {
+        if( x.empty() )
+            return;
+        base_ptr pos = split( position );
+        transfer( pos, x.header.next, &x.header );
+        length += x.length;
+        x.length = 0;
+    }
+    // 将i所指元素接合于position所指位置之前,position和i可能指向同一个链表
+    // i先被分裂成单独一个节点,再整个节点移动
+    void splice( iterator position, unrolled_list& x, iterator i )
+    {
+        iterator j = i;
+        ++j;
+        if( position == i || position == j )
+            return;
+        base_ptr pos = split( position, &i );
+        base_ptr first = split( i );
+        base_ptr last = split( iterator( first, 1 ) );
+        transfer( pos, first, last );
+        --x.length;
+        ++length;
+    }
+    // 将[first,last)内的所有元素接合于position所指之前
+    // position不能在区间中;区间来自另一个链表时,须逐个节点累计元素个数,代价O(区间节点数)
+    void splice( iterator position, unrolled_list& x, iterator first, iterator last )
+    {
+        if( first == last )
+            return;
+        base_ptr pos = split( position, &first, &last );
+        base_ptr f = split( first, &last );
+        base_ptr l = split( last );
+        if( &x != this )
+        {
+            size_type n = 0;
+            for( base_ptr p = f; p != l; p = p->next )
+                n += static_cast<link_type>( p )->count;
+            x.length -= n;
+            length += n;
+        }
+        transfer( pos, f, l );
+    }
+
+    // 将x合并到*this上,两个链表必须都已经过递增排序,相等时*this的元素在前(稳定)
+    // 元素依序复制到输出节点,输入节点一旦取空就回收作为输出节点,整个过程只需多配置一两个节点
+    // 比较或复制抛出异常时,已输出的元素与两条链余下的元素都留在*this中(不再有序),x成为空的链表
+    void merge( unrolled_list& x ) { merge( x, __list_less<T>() ); }
+    template <class Compare>
+    void merge( unrolled_list& x, Compare comp )
+    {
+        if( &x == this || x.empty() )
+            return;
+        // x整个不小于*this的尾元素时,直接接到尾端
+        if( empty() || !comp( x.front(), back() ) )
+        {
+            splice( end(), x );
+            return;
+        }
+        // 把两条节点链取下来,以空指针结尾
+        base_ptr a = header.next;
+        base_ptr b = x.header.next;
+        header.prev->next = 0;
+        x.header.prev->next = 0;
+        const size_type total = length + x.length;
+        empty_initialize();
+        x.empty_initialize();
+
+        size_t ia = 0, ib = 0;
+        base_ptr spare = 0;         // 回收的空节点,以next串接
+        link_type out = 0;
+        try
+        {
+            while( a && b )
+            {
+                link_type pa = static_cast<link_type>( a );
+                link_type pb = static_cast<link_type>( b );
+                const bool take_b = comp( pb->data()[ib], pa->data()[ia] );
+                link_type src = take_b ? pb : pa;
+                size_t& idx = take_b ? ib : ia;
+                base_ptr& chain = take_b ? b : a;
+                if( out == 0 || out->count == size_t( node_capacity ) )
+                    out = next_output_node( spare );
+                construct( out->data() + out->count, src->data()[idx] );
+                ++out->count;
+                destroy( src->data() + idx );
+                if( ++idx == src->count )
+                {
+                    // 输入节点已取空,回收
+                    chain = src->next;
+                    idx = 0;
+                    src->next = spare;
+                    spare = src;
+                }
+            }
+            // 剩下的一条链:当前节点余下的元素照样复制,其后的整个节点直接接上
+            base_ptr& rest = a ? a : b;
+            size_t& irest = a ? ia : ib;
+            if( rest && irest != 0 )
+            {
+                link_type src = static_cast<link_type>( rest );
+                for( ; irest < src->count; ++irest )
+                {
+                    if( out->count == size_t( node_capacity ) )
+                        out = next_output_node( spare );
+                    construct( out->data() + out->count, src->data()[irest] );
+                    ++out->count;
+                    destroy( src->data() + irest );
+                }
+                rest = src->next;
+                irest = 0;
+                put_node( src );
+            }
+        }
+        catch(...)
+        {
+            // 刚取得的输出节点可能还没有元素
+            if( out && out->count == 0 )
+            {
+                unlink( out );
+                put_node( out );
+            }
+            relink_chain( a, ia );
+            relink_chain( b, ib );
+            while( spare )
+            {
+                base_ptr next = spare->next;
+                put_node( spare );
+                spare = next;
+            }
+            length = 0;
+            for( base_ptr n = header.next; n != &header; n = n->next )
+                length += static_cast<link_type>( n )->count;
+            throw;
+        }
+        base_ptr rest = a ? a : b;
+        while( rest )
+        {
+            base_ptr next = rest->next;
+            link_before( &header, rest );
+            rest = next;
+        }
+        while( spare )
+        {
+            base_ptr next = spare->next;
+            put_node( spare );
+            spare = next;
+        }
+        length = total;
+    }
+
+    // 将*this的内容逆向重置:节点顺序逆转,每个节点内的元素也逆转
+    void reverse()
+    {
+        base_ptr n = &header;
+        do
+        {
+            std::swap( n->prev, n->next );
+            n = n->prev;        // 原来的next
+            if( n != &header )
+            {
+                link_type p = static_cast<link_type>( n );
+                std::reverse( p->data(), p->data() + p->count );
+            }
+        } while( n != &header );
+    }
+
+    // 与list::sort()相同的二进制计数合并
+    // 每次取下一整个节点,节点内先以插入排序排好,合并时各节点内部是连续的内存访问
+    void sort() { sort( __list_less<T>() ); }
+    template <class Compare>
+    void sort( Compare comp )
+    {
+        if( length < 2 )
+            return;
+        unrolled_list carry;
+        unrolled_list counter[64];
+        int fill = 0;
+        while( !empty() )
+        {
+            carry.splice( carry.begin(), *this, begin(), iterator( header.next->next, 0 ) );
+            link_type p = static_cast<link_type>( carry.header.next );
+            T* d = p->data();
+            for( size_t j = 1; j < p->count; ++j )
+            {
+                // 稳定的插入排序
+                T val = d[j];
+                size_t k = j;
+                for( ; k > 0 && comp( val, d[k - 1] ); --k )
+                    d[k] = d[k - 1];
+                d[k] = val;
+            }
+            int i = 0;
+            while( i < fill && !counter[i].empty() )
+            {
+                counter[i].merge( carry, comp );
+                carry.swap( counter[i++] );
+            }
+            carry.swap( counter[i] );
+            if( i == fill ) fill++;
+        }
+        for( int i = 1; i < fill; ++i )
+            counter[i].merge( counter[i-1], comp );
+        swap( counter[fill - 1] );
+    }
+
+    // 交换两个链表,内嵌头节点的前后节点要重新指回来
+    void swap( unrolled_list& x )
+    {
+        std::swap( header, x.header );
+        std::swap( length, x.length );
+        if( header.next == &x.header )
+            header.next = header.prev = &header;
+        else
+            header.next->prev = header.prev->next = &header;
+        if( x.header.next == &header )
+            x.header.next = x.header.prev = &x.header;
+        else
+            x.header.next->prev = x.header.prev->next = &x.header;
+    }
+};
+
+// 设置缓冲区的大小
+// 传入BufSiz(元素个数),元素大小,传回元素个数
+// 处理默认情况BufSiz为0的情况
+// 如果n不为0,传回n,表示buffer size 是用户自定义的
+// 如果n为0,表示buffer size使用默认值,那么
+// 如果sz(元素大小)小于512/sz
+// 如果sz不小于512,传回1
+inline constexpr size_t __deque_buf_size( size_t n, size_t sz )
+{
+    return n != 0 ? n : ( sz < 512 ? size_t( 512/sz ) : size_t(1) );
+}
+
+// deque缓冲区的配置策略，编译期决定
+// Bytes     每个缓冲区的目标字节数，元素个数为Bytes / sizeof(T)
+// MinElems  每个缓冲区至少容纳的元素个数，避免大元素一个缓冲区只放一个
+// Align     缓冲区的对齐边界(例如64为cache line，4096为page)，0表示由配置器决定
+// CompactIterator 迭代器只存cur与node两个字，缓冲区头尾由*node算出，见__deque_iterator_base
+// 缺省值即SGI原来的规则：512字节，元素不小于512字节时每个缓冲区一个元素，四个字的迭代器
+// 分段算法以缓冲区为分块单位，缓冲区越大，每段的连续区间越长
+template <size_t Bytes = 512, size_t MinElems = 1, size_t Align = 0, bool CompactIterator = false>
+struct deque_buffer_policy
+{
+    static const size_t bytes = Bytes;
+    static const size_t min_elems = MinElems;
+    static const size_t align = Align;
+    static const bool compact_iterator = CompactIterator;
+};
+
+// 常用的策略：按cache line对齐的4KiB缓冲区，以及按page对齐的64KiB缓冲区
+typedef deque_buffer_policy<4096, 4, 64> deque_cache_buffers;
+typedef deque_buffer_policy<65536, 16, 4096> deque_page_buffers;
+
+// 由BufSiz与策略算出每个缓冲区的元素个数，BufSiz不为0时以BufSiz为准
+template <class T, size_t BufSiz, class Policy>
+struct __deque_buf_elems
+{
+    static const size_t by_bytes = Policy::bytes / sizeof(T);
+    static const size_t value = BufSiz != 0 ? BufSiz
+                              : ( by_bytes >= Policy::min_elems ? by_bytes : Policy::min_elems );
+};
+
+// 缓冲区的配置器：策略要求对齐时使用__aligned_alloc，否则使用容器的配置器
+template <class Alloc, class Policy>
+struct __deque_buf_alloc
+{
+    typedef typename std::conditional< Policy::align == 0, Alloc, __aligned_alloc<Policy::align> >::type type;
+};
+
+// 不大于N的最大的2的幂的对数
+template <size_t N>
+struct __log2_floor { static const size_t value = N <= 1 ? 0 : 1 + __log2_floor<N / 2>::value; };
+template <>
+struct __log2_floor<0> { static const size_t value = 0; };
+
+// 把相对于当前缓冲区头的偏移量offset拆成节点的偏移与缓冲区内的偏移，N为缓冲区大小
+// 编译期依N选择做法：一般情形做除法，负的offset要向下取整
+template <size_t N, bool Pow2 = ( N & ( N - 1 ) ) == 0>
+struct __deque_buf_index
+{
+    static ptrdiff_t node_offset( ptrdiff_t offset )
+    {
+        if( offset >= 0 && offset < ptrdiff_t( N ) )    // 仍在同一个缓冲区，不必做除法
+            return 0;
+        return offset > 0 ? offset / ptrdiff_t( N ) : -ptrdiff_t( ( -offset - 1 ) / N ) - 1;
+    }
+    static ptrdiff_t elem_offset( ptrdiff_t offset, ptrdiff_t node_offset )
+    {
+        return offset - node_offset * ptrdiff_t( N );
+    }
+};
+// N为2的幂：算术右移本身就是向下取整，缓冲区内的偏移取低位即可，没有除法也没有分支
+template <size_t N>
+struct __deque_buf_index<N, true>
+{
+    static const size_t shift = __log2_floor<N>::value;
+    static ptrdiff_t node_offset( ptrdiff_t offset ) { return offset >> shift; }
+    static ptrdiff_t elem_offset( ptrdiff_t offset, ptrdiff_t ) { return offset & ptrdiff_t( N - 1 ); }
+};
+
+// deque迭代器的成员与缓冲区头尾的取得，N为缓冲区大小
+// Compact为false时存cur、first、last、node四个字，即SGI原来的布局
+// Compact为true时只存cur与node两个字，缓冲区的头尾由*node与编译期的缓冲区大小算出：
+// 复制迭代器的成本减半，代价是判断是否走到缓冲区边界时要多读一次*node
+// 布局是型别的一部分，两种迭代器是不同的型别，不会因编译选项不同而违反ODR
+template <class T, size_t N, bool Compact>
+struct __deque_iterator_base
+{
+    T* cur;         // 此迭代器所指之缓冲区中的现行元素
+    T* first;       // 此迭代器所指之缓冲区的头
+    T* last;        // 此迭代器所指之缓冲区的尾(含备用空间)
+    T** node;       // 指向管控中心(中控器)
+                    // 可以理解为deque的map的下标
+
+    __deque_iterator_base() : cur(0), first(0), last(0), node(0) {}
+
+    T* buf_first() const { return first; }
+    T* buf_last() const { return last; }
+
+    // 跳转至下一个缓冲区
+    void set_node( T** new_node )
+    {
+        node = new_node;
+        first = *new_node;
+        last = first + ptrdiff_t( N );
+    }
+};
+template <class T, size_t N>
+struct __deque_iterator_base<T, N, true>
+{
+    T* cur;
+    T** node;
+
+    __deque_iterator_base() : cur(0), node(0) {}
+
+    T* buf_first() const { return *node; }
+    T* buf_last() const { return *node + ptrdiff_t( N ); }
+
+    void set_node( T** new_node ) { node = new_node; }
+};
+
+// deque需要知道缓冲区的大小
+// Compact选择迭代器的布局，见__deque_iterator_base；缓冲区的头尾一律经由buf_first()、buf_last()取得
+template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact = false>
+struct __deque_iterator // 未继承std::iterator
+    : public __deque_iterator_base<T, __deque_buf_size( BufSiz, sizeof(T) ), Compact>
+{
+    typedef __deque_iterator<T, T&, T*, BufSiz, Compact> iterator;
+    typedef __deque_iterator<T, const T&, const T*, BufSiz, Compact> const_iterator;
+    // 缓冲区大小，编译期常量
+    static const size_t buf_size = __deque_buf_size( BufSiz, sizeof(T) );
+    static constexpr size_t buffer_size() { return buf_size; }
+
+    typedef random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef Ptr pointer;
+    typedef Ref reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    // 与容器联系
+    typedef T** map_pointer;
+
+    typedef __deque_iterator self;
+    typedef __deque_iterator_base<T, buf_size, Compact> base;
+
+    // 成员(与容器联接)
+    using base::cur;
+    using base::node;
+    using base::buf_first;
+    using base::buf_last;
+    using base::set_node;
+
+    // ctor
+    __deque_iterator() {}
+    // iterator转为const_iterator；复制构造与赋值都由编译器产生
+    template <class R, class P>
+    __deque_iterator( const __deque_iterator<T, R, P, BufSiz, Compact>& x,
+                      typename std::enable_if<std::is_same<R, T&>::value>::type* = 0 ) : base( x ) {}
+
+    // 重载运算符
+    reference operator*() const { return *cur; }
+    pointer operator->() const { return &(operator*()); }
+
+    difference_type operator-( const self& x ) const
+    {
+        // 计算思路:
+        // 如 1--2--3--4--5
+        // this在1,x在5
+        // 2.3.4是完整的,乘以缓冲区大小
+        // 再分别计算1中与5中的位置差距
+        // 缓冲区大小是编译期常量，2的幂时乘法即位移
+        return difference_type( buf_size ) * ( node - x.node ) + ( cur - buf_first() ) - ( x.cur - x.buf_first() );
+    }
+    // 前置加加
+    self& operator++()
+    {
+        ++cur;
+        if( cur == buf_last() )
+        {
+            set_node( node+1 );
+            cur = buf_first();
+        }
+        return *this;
+    }
+    // 后置加加
+    self operator++(int)
+    {
+        self tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    // 前置--
+    self& operator--()
+    {
+        if( cur == buf_first() )
+        {
+            set_node( node - 1 );
+            cur = buf_last();
+        }
+        --cur;
+        return *this;
+    }
+    // 后置--
+    self operator--(int)
+    {
+        self tmp = *this;
+        --*this;
+        return tmp;
+    }
+    // 实现随机存取,迭代器可以直接跳跃n个距离
+    // 节点偏移由__deque_buf_index计算，缓冲区大小为2的幂时只有位移与遮罩
+    self& operator+=( difference_type n )
+    {
+        typedef __deque_buf_index<buf_size> index;
+        difference_type offset = n + ( cur - buf_first() );
+        difference_type node_offset = index::node_offset( offset );
+        if( node_offset == 0 )
+            // 在同一个缓冲区
+            cur += n;
+        else
+        {
+            // 切换至正确的缓冲区
+            set_node( node + node_offset );
+            // 切换至正确的元素
+            cur = buf_first() + index::elem_offset( offset, node_offset );
+        }
+        return *this;
+    }
+    self operator+( difference_type n )const
+    {
+        self tmp = *this;
+        return tmp += n;
+    }
+    self& operator-=( difference_type n )
+    {
+        return *this += -n;
+    }
+    self operator-( difference_type n ) const
+    {
+        self tmp = *this;
+        return tmp -= n;
+    }
+
+    // 不建立临时迭代器，直接由map取得元素
+    reference operator[]( difference_type n ) const
+    {
+        typedef __deque_buf_index<buf_size> index;
+        difference_type offset = n + ( cur - buf_first() );
+        difference_type node_offset = index::node_offset( offset );
+        if( node_offset == 0 )
+            return cur[n];
+        return node[node_offset][ index::elem_offset( offset, node_offset ) ];
+    }
+
+    bool operator==( const self& x ) const { return cur == x.cur; }
+    bool operator!=( const self& x ) const { return cur != x.cur; }
+    bool operator< ( const self& x ) const { return ( node == x.node ) ? ( cur < x.cur ) : ( node < x.node ) ; }
+    bool operator> ( const self& x ) const { return x < *this; }
+    bool operator<=( const self& x ) const { return !( x < *this ); }
+    bool operator>=( const self& x ) const { return !( *this < x ); }
+};
+
+// 萃取deque迭代器所指之物的型别，destroy(first, last)据此略过trivial dtor的逐个析构
+template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact>
+inline T* value_type( const __deque_iterator<T, Ref, Ptr, BufSiz, Compact>& )
+{
+    return static_cast<T*>(0);
+}
+
+// 分段算法
+// 一般算法走访deque时，每次++都要检查是否走到缓冲区尾端、是否切换节点，+=还要做一次除法
+// 以下重载改为一次处理一整个缓冲区：在每段连续区间上以原生指针执行
+// (可以向量化，POD型别的复制与填充直接走memmove、SIMD核心)，只在段与段之间切换节点
+// 声明在deque之前，deque内部以LYH::限定调用copy、uninitialized_copy等时也会选中它们
+namespace LYH
+{
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact, class Function>
+    Function for_each( __deque_iterator<T, Ref, Ptr, BufSiz, Compact> first,
+                       __deque_iterator<T, Ref, Ptr, BufSiz, Compact> last, Function f )
+    {
+        for( ; first.node != last.node; first.set_node( first.node + 1 ), first.cur = first.buf_first() )
+            for( T* p = first.cur; p != first.buf_last(); ++p )
+                f( *p );
+        for( T* p = first.cur; p != last.cur; ++p )
+            f( *p );
+        return f;
+    }
+
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact, class V>
+    __deque_iterator<T, Ref, Ptr, BufSiz, Compact> find( __deque_iterator<T, Ref, Ptr, BufSiz, Compact> first,
+                                                __deque_iterator<T, Ref, Ptr, BufSiz, Compact> last, const V& value )
+    {
+        for( ; first.node != last.node; first.set_node( first.node + 1 ), first.cur = first.buf_first() )
+        {
+            T* p = LYH::find( first.cur, first.buf_last(), value );
+            if( p != first.buf_last() )
+            {
+                first.cur = p;
+                return first;
+            }
+        }
+        first.cur = LYH::find( first.cur, last.cur, value );
+        return first;
+    }
+
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact, class V>
+    V accumulate( __deque_iterator<T, Ref, Ptr, BufSiz, Compact> first,
+                  __deque_iterator<T, Ref, Ptr, BufSiz, Compact> last, V init )
+    {
+        for( ; first.node != last.node; first.set_node( first.node + 1 ), first.cur = first.buf_first() )
+            init = LYH::accumulate( (const T*) first.cur, (const T*) first.buf_last(), init );
+        return LYH::accumulate( (const T*) first.cur, (const T*) last.cur, init );
+    }
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact, class V, class BinaryOperation>
+    V accumulate( __deque_iterator<T, Ref, Ptr, BufSiz, Compact> first,
+                  __deque_iterator<T, Ref, Ptr, BufSiz, Compact> last, V init, BinaryOperation op )
+    {
+        for( ; first.node != last.node; first.set_node( first.node + 1 ), first.cur = first.buf_first() )
+            init = LYH::accumulate( (const T*) first.cur, (const T*) first.buf_last(), init, op );
+        return LYH::accumulate( (const T*) first.cur, (const T*) last.cur, init, op );
+    }
+
+    // 填充值的型别V独立于元素，以0填充deque<long>时也走这里
+    template <class T, size_t BufSiz, class V, bool Compact>
+    void fill( __deque_iterator<T, T&, T*, BufSiz, Compact> first,
+               __deque_iterator<T, T&, T*, BufSiz, Compact> last, const V& value )
+    {
+        for( ; first.node != last.node; first.set_node( first.node + 1 ), first.cur = first.buf_first() )
+            LYH::fill( first.cur, first.buf_last(), value );
+        LYH::fill( first.cur, last.cur, value );
+    }
+
+    // 复制时来源与目的的缓冲区边界不一定对齐，每次取两者剩余长度中较短的一段
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact>
+    __deque_iterator<T, T&, T*, BufSiz, Compact> copy( __deque_iterator<T, Ref, Ptr, BufSiz, Compact> first,
+                                              __deque_iterator<T, Ref, Ptr, BufSiz, Compact> last,
+                                              __deque_iterator<T, T&, T*, BufSiz, Compact> result )
+    {
+        ptrdiff_t n = last - first;
+        while( n > 0 )
+        {
+            ptrdiff_t len = std::min( n, std::min( first.buf_last() - first.cur, result.buf_last() - result.cur ) );
+            LYH::copy( (const T*) first.cur, (const T*) first.cur + len, result.cur );
+            first += len;
+            result += len;
+            n -= len;
+        }
+        return result;
+    }
+    // 由连续空间复制到deque
+    template <class T, size_t BufSiz, bool Compact>
+    __deque_iterator<T, T&, T*, BufSiz, Compact> copy( const T* first, const T* last,
+                                              __deque_iterator<T, T&, T*, BufSiz, Compact> result )
+    {
+        ptrdiff_t n = last - first;
+        while( n > 0 )
+        {
+            ptrdiff_t len = std::min( n, result.buf_last() - result.cur );
+            LYH::copy( first, first + len, result.cur );
+            first += len;
+            result += len;
+            n -= len;
+        }
+        return result;
+    }
+    template <class T, size_t BufSiz, bool Compact>
+    inline __deque_iterator<T, T&, T*, BufSiz, Compact> copy( T* first, T* last,
+                                                     __deque_iterator<T, T&, T*, BufSiz, Compact> result )
+    {
+        return LYH::copy( (const T*) first, (const T*) last, result );
+    }
+    // 由deque复制到连续空间
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact>
+    T* copy( __deque_iterator<T, Ref, Ptr, BufSiz, Compact> first,
+             __deque_iterator<T, Ref, Ptr, BufSiz, Compact> last, T* result )
+    {
+        for( ; first.node != last.node; first.set_node( first.node + 1 ), first.cur = first.buf_first() )
+            result = LYH::copy( (const T*) first.cur, (const T*) first.buf_last(), result );
+        return LYH::copy( (const T*) first.cur, (const T*) last.cur, result );
+    }
+
+    // 由尾端往前复制，每次取last与result各自之前的连续长度中较短的一段
+    // 位于缓冲区开头时，之前的连续区间是上一个缓冲区的整块
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact>
+    __deque_iterator<T, T&, T*, BufSiz, Compact> copy_backward( __deque_iterator<T, Ref, Ptr, BufSiz, Compact> first,
+                                                       __deque_iterator<T, Ref, Ptr, BufSiz, Compact> last,
+                                                       __deque_iterator<T, T&, T*, BufSiz, Compact> result )
+    {
+        const ptrdiff_t buf = ptrdiff_t( __deque_iterator<T, Ref, Ptr, BufSiz, Compact>::buffer_size() );
+        ptrdiff_t n = last - first;
+        while( n > 0 )
+        {
+            ptrdiff_t llen = last.cur - last.buf_first();
+            T* lend = last.cur;
+            if( llen == 0 )
+            {
+                llen = buf;
+                lend = *( last.node - 1 ) + buf;
+            }
+            ptrdiff_t rlen = result.cur - result.buf_first();
+            T* rend = result.cur;
+            if( rlen == 0 )
+            {
+                rlen = buf;
+                rend = *( result.node - 1 ) + buf;
+            }
+            ptrdiff_t len = std::min( n, std::min( llen, rlen ) );
+            LYH::copy_backward( (const T*) lend - len, (const T*) lend, rend );
+            last -= len;
+            result -= len;
+            n -= len;
+        }
+        return result;
+    }
+
+    // 分段的uninitialized_copy，中途抛出异常则析构已构造的元素
+    template <class T, class Ref, class Ptr, size_t BufSiz, bool Compact>
+    __deque_iterator<T, T&, T*, BufSiz, Compact> uninitialized_copy( __deque_iterator<T, Ref, Ptr, BufSiz, Compact> first,
+                                                            __deque_iterator<T, Ref, Ptr, BufSiz, Compact> last,
+                                                            __deque_iterator<T, T&, T*, BufSiz, Compact> result )
+    {
+        __deque_iterator<T, T&, T*, BufSiz, Compact> cur = result;
+        ptrdiff_t n = last - first;
+        try
+        {
+            while( n > 0 )
+            {
+                ptrdiff_t len = std::min( n, std::min( first.buf_last() - first.cur, cur.buf_last() - cur.cur ) );
+                LYH::uninitialized_copy( (const T*) first.cur, (const T*) first.cur + len, cur.cur );
+                first += len;
+                cur += len;
+                n -= len;
+            }
+        }
+        catch(...)
+        {
+            destroy( result, cur );
+            throw;
+        }
+        return cur;
+    }
+}
+
+
+// BufSiz 指出缓冲区的大小(元素个数)，为0时由BufPolicy决定
+// BufPolicy 缓冲区的字节数、最少元素个数与对齐，见deque_buffer_policy
+// deque 可以理解为维护一个数组的数组
+// deque需要两个自带迭代器,指出首末元素
+template <class T, class Alloc = alloc, size_t BufSiz = 0, class BufPolicy = deque_buffer_policy<> >
+class deque
+{
+public:
+    // 内嵌型定义
+    typedef T                    value_type;
+    typedef value_type*          pointer;
+    // 迭代器直接带着算好的缓冲区大小
+    typedef __deque_iterator<T, T&, T*, __deque_buf_elems<T, BufSiz, BufPolicy>::value,
+                             BufPolicy::compact_iterator> iterator;
+    typedef __deque_iterator<T, const T&, const T*, __deque_buf_elems<T, BufSiz, BufPolicy>::value,
+                             BufPolicy::compact_iterator> const_iterator;
+    typedef value_type&          reference;
+    typedef const value_type&    const_reference;
+    typedef size_t               size_type;
+    typedef ptrdiff_t            difference_type;
+
+protected:
+    // 内部定义
+    // 元素的指针的指针
+    // 即指向map的空间
+    typedef pointer* map_pointer;
+
+protected:
+    // 成员
+    map_pointer map;        // 指向map,map是一片连续的空间,每个元素是一个指针,指向一块缓冲区
+    size_type map_size;     // map内有多少指针,即deque有多少个二级数组
+    iterator start;         // 表现第一个
+    iterator finish;        // 表现最后一个节点
+
+    // 备用缓冲区：pop释放的缓冲区先留在这里，下次需要新缓冲区时直接取用
+    // 队列式的用法(push_back与pop_front交替)在稳定状态下不必配置缓冲区
+    // 备用缓冲区以各自的第一个字串接
+    pointer spare;
+    size_type spare_count;
+    size_type spare_limit;  // 备用缓冲区个数的上限
+
+protected:
+    // 专属空间配置器,每次配置一个元素大小
+    // 策略要求对齐时，缓冲区改由对齐的配置器配置
+    typedef simple_alloc<value_type, typename __deque_buf_alloc<Alloc, BufPolicy>::type> data_allocator;
+    // 专属空间配置器,每次配置一个指针大小
+    typedef simple_alloc<pointer, Alloc> map_allocator;
+
+public:
+    // 每个缓冲区的元素个数
+    static constexpr size_type buffer_size() { return iterator::buffer_size(); }
+
+protected:
+    // map最少管理8个节点
+    static size_type initial_map_size() { return 8; }
+
+public:
+    // 构造
+    deque()
+    : map(0), map_size(0), start(), finish(), spare(0), spare_count(0), spare_limit(2)
+    {
+        creat_map_and_nodes( 0 );
+    }
+    deque( size_type n, const value_type& value )
+    : map(0), map_size(0), start(), finish(), spare(0), spare_count(0), spare_limit(2)
+    {
+        fill_initialize( n, value );
+    }
+    deque( int n, const value_type& value )
+    : map(0), map_size(0), start(), finish(), spare(0), spare_count(0), spare_limit(2)
+    {
+        fill_initialize( n, value );
+    }
+    explicit deque( size_type n )
+    : map(0), map_size(0), start(), finish(), spare(0), spare_count(0), spare_limit(2)
+    {
+        fill_initialize( n, value_type() );
+    }
+    deque( const deque& x )
+    : map(0), map_size(0), start(), finish(), spare(0), spare_count(0), spare_limit(2)
+    {
+        creat_map_and_nodes( x.size() );
+        try
+        {
+            LYH::uninitialized_copy( x.begin(), x.end(), start );
+        }
+        catch(...)
+        {
+            destroy_map_and_nodes();
+            throw;
+        }
+    }
+    deque& operator=( const deque& x )
+    {
+        if( &x != this )
+        {
+            deque tmp( x );
+            swap( tmp );
+        }
+        return *this;
+    }
+    // 析构
+    ~deque()
+    {
+        destroy( start, finish );
+        destroy_map_and_nodes();
+    }
+
+protected:
+    void fill_initialize( size_type n, const value_type& value )
+    {
+        creat_map_and_nodes(n);
+        map_pointer cur;
+        try
+        {
+            // 除最后一个缓冲区外都是满的
+            for( cur = start.node; cur < finish.node; ++cur )
+                LYH::uninitialized_fill( *cur, *cur + buffer_size(), value );
+            LYH::uninitialized_fill( finish.buf_first(), finish.cur, value );
+        }
+        catch(...)
+        {
+            for( map_pointer n = start.node; n < cur; ++n )
+                destroy( *n, *n + buffer_size() );
+            destroy_map_and_nodes();
+            throw;
+        }
+    }
+    // 配置map与容纳num_elements个元素所需的缓冲区，元素本身不构造
+    void creat_map_and_nodes( size_type num_elements )
+    {
+        // 需要的节点数 = (元素个数 / 每个缓冲区可容纳的元素个数) + 1
+        // 刚好整除时会多配一个节点，finish.cur指向它的开头
+        size_type num_nodes = num_elements / buffer_size() + 1;
+        // map前后各预留一个，扩充时可用
+        map_size = std::max( initial_map_size(), num_nodes + 2 );
+        map = map_allocator::allocate( map_size );
+        // 令nstart与nfinish指向map的中间，使头尾两端的扩充能量一样大
+        map_pointer nstart = map + ( map_size - num_nodes ) / 2;
+        map_pointer nfinish = nstart + num_nodes - 1;
+        map_pointer cur;
+        try
+        {
+            for( cur = nstart; cur <= nfinish; ++cur )
+                *cur = allocate_node();
+        }
+        catch(...)
+        {
+            for( map_pointer n = nstart; n < cur; ++n )
+                deallocate_node( *n );
+            map_allocator::deallocate( map, map_size );
+            map = 0;
+            map_size = 0;
+            throw;
+        }
+        start.set_node( nstart );
+        finish.set_node( nfinish );
+        start.cur = start.buf_first();
+        finish.cur = finish.buf_first() + num_elements % buffer_size();
+    }
+    // 释放所有缓冲区(连同备用的)与map，元素必须已经析构
+    void destroy_map_and_nodes()
+    {
+        for( map_pointer cur = start.node; cur <= finish.node; ++cur )
+            deallocate_node( *cur );
+        trim_spare( 0 );
+        map_allocator::deallocate( map, map_size );
+    }
+
+    // 配置一个缓冲区，优先取用备用缓冲区
+    pointer allocate_node()
+    {
+        if( spare != 0 )
+        {
+            pointer p = spare;
+            spare = *reinterpret_cast<pointer*>( p );
+            --spare_count;
+            return p;
+        }
+        return data_allocator::allocate( buffer_size() );
+    }
+    // 释放一个缓冲区，备用的未满时留下备用
+    // 缓冲区小于一个指针时无法串接，直接交还
+    void deallocate_node( pointer p )
+    {
+        if( spare_count < spare_limit && buffer_size() * sizeof(value_type) >= sizeof(pointer) )
+        {
+            *reinterpret_cast<pointer*>( p ) = spare;
+            spare = p;
+            ++spare_count;
+            return;
+        }
+        data_allocator::deallocate( p, buffer_size() );
+    }
+    // 备用缓冲区只留下n个
+    void trim_spare( size_type n )
+    {
+        while( spare_count > n )
+        {
+            pointer p = spare;
+            spare = *reinterpret_cast<pointer*>( p );
+            --spare_count;
+            data_allocator::deallocate( p, buffer_size() );
+        }
+    }
+
+public:
+    // 基础数据行为
+    iterator begin() { return start; }
+    iterator end() { return finish; }
+    const_iterator begin() const { return start; }
+    const_iterator end() const { return finish; }
+
+    reference operator[]( size_type n )
+    {
+        return start[difference_type(n)];
+    }
+    const_reference operator[]( size_type n ) const
+    {
+        return start[difference_type(n)];
+    }
+
+    reference front() { return *start; }
+    reference back()
     {
         iterator tmp = finish;
         --tmp;
         return *tmp;
     }
+    const_reference front() const { return *start; }
+    const_reference back() const
+    {
+        const_iterator tmp = finish;
+        --tmp;
+        return *tmp;
+    }
 
     size_type size() const { return finish - start; }
     size_type max_size() const { return size_type(-1); }
     bool empty() const { return finish == start; }
 
+    // 设定备用缓冲区个数的上限，超出的立即交还配置器
+    void set_buffer_cache_limit( size_type n )
+    {
+        spare_limit = n;
+        trim_spare( n );
+    }
+    // 交还所有备用缓冲区
+    void shrink_to_fit() { trim_spare( 0 ); }
+
+public:
+    // 在尾端添加元素
+    void push_back( const value_type& x )
+    {
+        if( finish.cur != finish.buf_last() - 1 )
+        {
+            // 最后一个缓冲区尚有两个(含)以上的元素备用空间
+            construct( finish.cur, x );
+            ++finish.cur;
+        }
+        else
+            // 最后一个缓冲区只剩一个元素备用空间
+            push_back_aux( x );
+    }
+    // 在头端添加元素
+    void push_front( const value_type& x )
+    {
+        if( start.cur != start.buf_first() )
+        {
+            // 第一缓冲区尚有备用空间
+            construct( start.cur - 1, x );
+            --start.cur;
+        }
+        else
+            push_front_aux( x );
+    }
+    // 移除尾端元素
+    void pop_back()
+    {
+        if( finish.cur != finish.buf_first() )
+        {
+            // 最后一个缓冲区有一个(或更多)元素
+            --finish.cur;
+            destroy( finish.cur );
+        }
+        else
+            // 最后一个缓冲区没有任何元素
+            pop_back_aux();
+    }
+    // 移除头端元素
+    void pop_front()
+    {
+        if( start.cur != start.buf_last() - 1 )
+        {
+            // 第一缓冲区有两个(或更多)元素
+            destroy( start.cur );
+            ++start.cur;
+        }
+        else
+            // 第一缓冲区仅有一个元素
+            pop_front_aux();
+    }
+
+    // 清除整个deque，保留一个缓冲区，这是deque的初始状态
+    void clear()
+    {
+        // 头尾以外的每一个缓冲区都一定是满的
+        for( map_pointer node = start.node + 1; node < finish.node; ++node )
+        {
+            destroy( *node, *node + buffer_size() );
+            deallocate_node( *node );
+        }
+        if( start.node != finish.node )
+        {
+            // 至少有头尾两个缓冲区
+            destroy( start.cur, start.buf_last() );
+            destroy( finish.buf_first(), finish.cur );
+            // 保留头缓冲区
+            deallocate_node( finish.buf_first() );
+        }
+        else
+            // 只有一个缓冲区
+            destroy( start.cur, finish.cur );
+        finish = start;
+    }
+
+    // 清除pos所指的元素，传回清除点之后的元素
+    // 清除点之前的元素较少就移动前面的元素，否则移动后面的元素
+    iterator erase( iterator pos )
+    {
+        iterator next = pos;
+        ++next;
+        difference_type index = pos - start;
+        if( size_type( index ) < ( size() >> 1 ) )
+        {
+            LYH::copy_backward( start, pos, next );
+            pop_front();
+        }
+        else
+        {
+            LYH::copy( next, finish, pos );
+            pop_back();
+        }
+        return start + index;
+    }
+    // 清除[first,last)区间内的所有元素
+    iterator erase( iterator first, iterator last )
+    {
+        if( first == start && last == finish )
+        {
+            clear();
+            return finish;
+        }
+        difference_type n = last - first;               // 清除区间的长度
+        difference_type elems_before = first - start;   // 清除区间前方的元素个数
+        if( elems_before < difference_type( ( size() - n ) / 2 ) )
+        {
+            // 前方的元素比较少，向后移动前方元素(覆盖清除区间)
+            LYH::copy_backward( start, first, last );
+            iterator new_start = start + n;
+            destroy( start, new_start );
+            for( map_pointer cur = start.node; cur < new_start.node; ++cur )
+                deallocate_node( *cur );
+            start = new_start;
+        }
+        else
+        {
+            // 后方的元素比较少，向前移动后方元素
+            LYH::copy( last, finish, first );
+            iterator new_finish = finish - n;
+            destroy( new_finish, finish );
+            for( map_pointer cur = new_finish.node + 1; cur <= finish.node; ++cur )
+                deallocate_node( *cur );
+            finish = new_finish;
+        }
+        return start + elems_before;
+    }
+
+    // 在position处插入一个元素，其值为x
+    iterator insert( iterator position, const value_type& x )
+    {
+        if( position.cur == start.cur )
+        {
+            // 插入点是deque最前端，交给push_front
+            push_front( x );
+            return start;
+        }
+        else if( position.cur == finish.cur )
+        {
+            // 插入点是deque最尾端，交给push_back
+            push_back( x );
+            iterator tmp = finish;
+            --tmp;
+            return tmp;
+        }
+        else
+            return insert_aux( position, x );
+    }
+    // 在position处插入n个元素，其值为x
+    void insert( iterator position, size_type n, const value_type& x )
+    {
+        if( n == 0 )
+            return;
+        if( position.cur == start.cur )
+        {
+            iterator new_start = reserve_elements_at_front( n );
+            try
+            {
+                LYH::uninitialized_fill( new_start, start, x );
+            }
+            catch(...)
+            {
+                destroy_nodes_at_front( new_start );
+                throw;
+            }
+            start = new_start;
+        }
+        else if( position.cur == finish.cur )
+        {
+            iterator new_finish = reserve_elements_at_back( n );
+            try
+            {
+                LYH::uninitialized_fill( finish, new_finish, x );
+            }
+            catch(...)
+            {
+                destroy_nodes_at_back( new_finish );
+                throw;
+            }
+            finish = new_finish;
+        }
+        else
+            insert_aux( position, n, x );
+    }
+    void insert( iterator position, int n, const value_type& x )
+    {
+        insert( position, size_type( n ), x );
+    }
+
+    // 改变元素个数，新增的元素值为x
+    void resize( size_type new_size, const value_type& x )
+    {
+        size_type len = size();
+        if( new_size < len )
+            erase( start + difference_type( new_size ), finish );
+        else
+            insert( finish, new_size - len, x );
+    }
+    void resize( size_type new_size ) { resize( new_size, value_type() ); }
+
+    // 交换两个deque，只需交换map与头尾迭代器
+    void swap( deque& x )
+    {
+        std::swap( map, x.map );
+        std::swap( map_size, x.map_size );
+        std::swap( start, x.start );
+        std::swap( finish, x.finish );
+        std::swap( spare, x.spare );
+        std::swap( spare_count, x.spare_count );
+        std::swap( spare_limit, x.spare_limit );
+    }
+
+protected:
+    // 只有当finish.cur == finish.buf_last() - 1时才会被调用
+    // 最后一个缓冲区只剩一个备用元素空间时
+    void push_back_aux( const value_type& x )
+    {
+        value_type x_copy = x;      // x可能是deque中的元素，map重整之前先复制下来
+        reserve_map_at_back();      // 若符合某种条件则必须重换一个map
+        *( finish.node + 1 ) = allocate_node();     // 配置一个新缓冲区
+        try
+        {
+            construct( finish.cur, x_copy );
+            finish.set_node( finish.node + 1 );     // 改变finish，令其指向新节点
+            finish.cur = finish.buf_first();
+        }
+        catch(...)
+        {
+            deallocate_node( *( finish.node + 1 ) );
+            throw;
+        }
+    }
+    // 只有当start.cur == start.first时才会被调用
+    // 第一个缓冲区没有任何备用元素时
+    void push_front_aux( const value_type& x )
+    {
+        value_type x_copy = x;
+        reserve_map_at_front();
+        *( start.node - 1 ) = allocate_node();
+        try
+        {
+            construct( *( start.node - 1 ) + buffer_size() - 1, x_copy );
+        }
+        catch(...)
+        {
+            deallocate_node( *( start.node - 1 ) );
+            throw;
+        }
+        start.set_node( start.node - 1 );
+        start.cur = start.buf_last() - 1;
+    }
+    // 只有当finish.cur == finish.first时才会被调用
+    void pop_back_aux()
+    {
+        deallocate_node( finish.buf_first() );    // 释放最后一个缓冲区
+        finish.set_node( finish.node - 1 ); // 调整finish的状态，使指向上一个缓冲区的最后一个元素
+        finish.cur = finish.buf_last() - 1;
+        destroy( finish.cur );
+    }
+    // 只有当start.cur == start.buf_last() - 1时才会被调用
+    void pop_front_aux()
+    {
+        destroy( start.cur );               // 将第一缓冲区的第一个(也是最后一个、唯一一个)元素析构
+        deallocate_node( start.buf_first() );     // 释放第一缓冲区
+        start.set_node( start.node + 1 );   // 调整start的状态，使指向下一个缓冲区的第一个元素
+        start.cur = start.buf_first();
+    }
+
+    // map尾端的节点备用空间不足时，必须重整map
+    void reserve_map_at_back( size_type nodes_to_add = 1 )
+    {
+        if( nodes_to_add + 1 > map_size - ( finish.node - map ) )
+            reallocate_map( nodes_to_add, false );
+    }
+    // map前端的节点备用空间不足时，必须重整map
+    void reserve_map_at_front( size_type nodes_to_add = 1 )
+    {
+        if( nodes_to_add > size_type( start.node - map ) )
+            reallocate_map( nodes_to_add, true );
+    }
+    // 重整map
+    // 已用的节点不到map的一半时，只把它们移回map的中央(recenter)，不配置新的map；
+    // 否则配置一个更大的map，已用的节点放在新map的中央
+    // 两种情况都只移动缓冲区的指针，缓冲区本身与其中的元素不动
+    void reallocate_map( size_type nodes_to_add, bool add_at_front )
+    {
+        size_type old_num_nodes = finish.node - start.node + 1;
+        size_type new_num_nodes = old_num_nodes + nodes_to_add;
+
+        map_pointer new_nstart;
+        if( map_size > 2 * new_num_nodes )
+        {
+            new_nstart = map + ( map_size - new_num_nodes ) / 2
+                             + ( add_at_front ? nodes_to_add : 0 );
+            if( new_nstart < start.node )
+                LYH::copy( start.node, finish.node + 1, new_nstart );
+            else
+                LYH::copy_backward( start.node, finish.node + 1, new_nstart + old_num_nodes );
+        }
+        else
+        {
+            size_type new_map_size = map_size + std::max( map_size, nodes_to_add ) + 2;
+            // 配置一块空间，准备给新map使用
+            map_pointer new_map = map_allocator::allocate( new_map_size );
+            new_nstart = new_map + ( new_map_size - new_num_nodes ) / 2
+                                 + ( add_at_front ? nodes_to_add : 0 );
+            // 把原map内容拷贝过来
+            LYH::copy( start.node, finish.node + 1, new_nstart );
+            // 释放原map
+            map_allocator::deallocate( map, map_size );
+            // 设定新map的起始地址与大小
+            map = new_map;
+            map_size = new_map_size;
+        }
+        // 重新设定迭代器start和finish
+        start.set_node( new_nstart );
+        finish.set_node( new_nstart + old_num_nodes - 1 );
+    }
+
+    // 在中间插入一个元素，移动元素较少的一端
+    iterator insert_aux( iterator pos, const value_type& x )
+    {
+        difference_type index = pos - start;    // 插入点之前的元素个数
+        value_type x_copy = x;
+        if( size_type( index ) < size() / 2 )
+        {
+            // 插入点之前的元素个数比较少
+            push_front( front() );              // 在最前端加入与第一个元素同值的元素
+            iterator front1 = start;
+            ++front1;
+            iterator front2 = front1;
+            ++front2;
+            pos = start + index;
+            iterator pos1 = pos;
+            ++pos1;
+            LYH::copy( front2, pos1, front1 );  // 元素移动
+        }
+        else
+        {
+            // 插入点之后的元素个数比较少
+            push_back( back() );                // 在最尾端加入与最后元素同值的元素
+            iterator back1 = finish;
+            --back1;
+            iterator back2 = back1;
+            --back2;
+            pos = start + index;
+            LYH::copy_backward( pos, back2, back1 );    // 元素移动
+        }
+        *pos = x_copy;
+        return pos;
+    }
+    // 在中间插入n个元素，移动元素较少的一端
+    void insert_aux( iterator pos, size_type n, const value_type& x )
+    {
+        const difference_type elems_before = pos - start;
+        size_type length = size();
+        value_type x_copy = x;
+        if( elems_before < difference_type( length / 2 ) )
+        {
+            iterator new_start = reserve_elements_at_front( n );
+            iterator old_start = start;
+            pos = start + elems_before;
+            try
+            {
+                if( elems_before >= difference_type( n ) )
+                {
+                    iterator start_n = start + difference_type( n );
+                    LYH::uninitialized_copy( start, start_n, new_start );
+                    start = new_start;
+                    LYH::copy( start_n, pos, old_start );
+                    LYH::fill( pos - difference_type( n ), pos, x_copy );
+                }
+                else
+                {
+                    iterator mid = LYH::uninitialized_copy( start, pos, new_start );
+                    try
+                    {
+                        LYH::uninitialized_fill( mid, start, x_copy );
+                    }
+                    catch(...)
+                    {
+                        destroy( new_start, mid );
+                        throw;
+                    }
+                    start = new_start;
+                    LYH::fill( old_start, pos, x_copy );
+                }
+            }
+            catch(...)
+            {
+                destroy_nodes_at_front( new_start );
+                throw;
+            }
+        }
+        else
+        {
+            iterator new_finish = reserve_elements_at_back( n );
+            iterator old_finish = finish;
+            const difference_type elems_after = difference_type( length ) - elems_before;
+            pos = finish - elems_after;
+            try
+            {
+                if( elems_after > difference_type( n ) )
+                {
+                    iterator finish_n = finish - difference_type( n );
+                    LYH::uninitialized_copy( finish_n, finish, finish );
+                    finish = new_finish;
+                    LYH::copy_backward( pos, finish_n, old_finish );
+                    LYH::fill( pos, pos + difference_type( n ), x_copy );
+                }
+                else
+                {
+                    iterator mid = pos + difference_type( n );
+                    LYH::uninitialized_fill( finish, mid, x_copy );
+                    try
+                    {
+                        LYH::uninitialized_copy( pos, finish, mid );
+                    }
+                    catch(...)
+                    {
+                        destroy( finish, mid );
+                        throw;
+                    }
+                    finish = new_finish;
+                    LYH::fill( pos, old_finish, x_copy );
+                }
+            }
+            catch(...)
+            {
+                destroy_nodes_at_back( new_finish );
+                throw;
+            }
+        }
+    }
+
+    // 保证start之前有n个元素的空间，传回新的start
+    iterator reserve_elements_at_front( size_type n )
+    {
+        size_type vacancies = start.cur - start.buf_first();
+        if( n > vacancies )
+            new_elements_at_front( n - vacancies );
+        return start - difference_type( n );
+    }
+    // 保证finish之后有n个元素的空间，传回新的finish
+    iterator reserve_elements_at_back( size_type n )
+    {
+        size_type vacancies = ( finish.buf_last() - finish.cur ) - 1;
+        if( n > vacancies )
+            new_elements_at_back( n - vacancies );
+        return finish + difference_type( n );
+    }
+    void new_elements_at_front( size_type new_elements )
+    {
+        size_type new_nodes = ( new_elements + buffer_size() - 1 ) / buffer_size();
+        reserve_map_at_front( new_nodes );
+        size_type i;
+        try
+        {
+            for( i = 1; i <= new_nodes; ++i )
+                *( start.node - i ) = allocate_node();
+        }
+        catch(...)
+        {
+            for( size_type j = 1; j < i; ++j )
+                deallocate_node( *( start.node - j ) );
+            throw;
+        }
+    }
+    void new_elements_at_back( size_type new_elements )
+    {
+        size_type new_nodes = ( new_elements + buffer_size() - 1 ) / buffer_size();
+        reserve_map_at_back( new_nodes );
+        size_type i;
+        try
+        {
+            for( i = 1; i <= new_nodes; ++i )
+                *( finish.node + i ) = allocate_node();
+        }
+        catch(...)
+        {
+            for( size_type j = 1; j < i; ++j )
+                deallocate_node( *( finish.node + j ) );
+            throw;
+        }
+    }
+    // 释放start之前、从before_start起多配置的缓冲区
+    void destroy_nodes_at_front( iterator before_start )
+    {
+        for( map_pointer n = before_start.node; n < start.node; ++n )
+            deallocate_node( *n );
+    }
+    // 释放finish之后、到after_finish为止多配置的缓冲区
+    void destroy_nodes_at_back( iterator after_finish )
+    {
+        for( map_pointer n = after_finish.node; n > finish.node; --n )
+            deallocate_node( *n );
+    }
 };
 
 
@@ -0,0 +1,326 @@
+//
+// SIMD填充与复制核心，供POD型别的fill、copy、copy_backward使用
+//
+
+#ifndef SEQUENCE_CONTAINERS_SIMD_KERNELS_H
+#define SEQUENCE_CONTAINERS_SIMD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>      // for memcpy, memmove
+
+// 只在x86上的GCC/Clang启用，定义LYH_NO_SIMD可强制使用标量版本
+#if !defined( LYH_NO_SIMD ) && defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+# define __LYH_SIMD_X86
+# include <immintrin.h>
+#endif
+
+// 超过此字节数的填充与复制改用非临时存储(绕过cache)，避免冲掉cache中的其他数据
+#ifndef LYH_SIMD_STREAM_BYTES
+# define LYH_SIMD_STREAM_BYTES ( 4 * 1024 * 1024 )
+#endif
+
+namespace LYH
+{
+    // 填充核心：pattern为64字节的样板，由元素重复排列而成
+    // 元素大小必须整除32，保证每次存储的起点都落在元素边界上
+    typedef void (* __simd_fill_fn)( void* dst, size_t bytes, const void* pattern );
+    // 复制核心：copy为前向复制(允许dst < src的重叠)
+    // copy_backward为后向复制，参数为两段区间的尾端(允许dst > src的重叠)
+    typedef void (* __simd_copy_fn)( void* dst, const void* src, size_t bytes );
+
+    struct __simd_kernels
+    {
+        __simd_fill_fn fill;
+        __simd_copy_fn copy;
+        __simd_copy_fn copy_backward;
+        const char* name;
+    };
+
+    // 标量版本，也是不支持SIMD时的后备
+    inline void __fill_bytes_scalar( void* dst, size_t bytes, const void* pattern )
+    {
+        char* d = static_cast<char*>( dst );
+        for( ; bytes >= 64; bytes -= 64, d += 64 )
+            memcpy( d, pattern, 64 );
+        memcpy( d, pattern, bytes );
+    }
+    inline void __copy_bytes_scalar( void* dst, const void* src, size_t bytes )
+    {
+        memmove( dst, src, bytes );
+    }
+    inline void __copy_backward_bytes_scalar( void* dst_end, const void* src_end, size_t bytes )
+    {
+        memmove( static_cast<char*>( dst_end ) - bytes, static_cast<const char*>( src_end ) - bytes, bytes );
+    }
+
+#ifdef __LYH_SIMD_X86
+    // 两段区间是否不重叠，只有不重叠时才使用非临时存储
+    inline bool __simd_disjoint( const void* a, const void* b, size_t bytes )
+    {
+        uintptr_t x = reinterpret_cast<uintptr_t>( a ), y = reinterpret_cast<uintptr_t>( b );
+        return x >= y ? x - y >= bytes : y - x >= bytes;
+    }
+
+    // AVX2，每次处理32字节
+    __attribute__(( target( "avx2" ) ))
+    inline void __fill_bytes_avx2( void* dst, size_t bytes, const void* pattern )
+    {
+        char* d = static_cast<char*>( dst );
+        const __m256i v = _mm256_loadu_si256( static_cast<const __m256i*>( pattern ) );
+        // 非临时存储要求目的地址32字节对齐
+        // 对齐所需跳过的字节数是元素大小的倍数时(即样板以该偏移旋转后不变)，相位才不会错开
+        size_t head = ( 32 - ( reinterpret_cast<uintptr_t>( d ) & 31 ) ) & 31;
+        if( bytes >= LYH_SIMD_STREAM_BYTES
+            && memcmp( pattern, static_cast<const char*>( pattern ) + head, 32 ) == 0 )
+        {
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d ), v );
+            d += head;
+            bytes -= head;
+            for( ; bytes >= 128; bytes -= 128, d += 128 )
+            {
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( d ), v );
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( d + 32 ), v );
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( d + 64 ), v );
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( d + 96 ), v );
+            }
+            _mm_sfence();
+        }
+        for( ; bytes >= 128; bytes -= 128, d += 128 )
+        {
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d ), v );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 32 ), v );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 64 ), v );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 96 ), v );
+        }
+        for( ; bytes >= 32; bytes -= 32, d += 32 )
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d ), v );
+        memcpy( d, pattern, bytes );
+    }
+
+    __attribute__(( target( "avx2" ) ))
+    inline void __copy_bytes_avx2( void* dst, const void* src, size_t bytes )
+    {
+        char* d = static_cast<char*>( dst );
+        const char* s = static_cast<const char*>( src );
+        if( bytes >= LYH_SIMD_STREAM_BYTES && __simd_disjoint( d, s, bytes ) )
+        {
+            // 先以memmove补齐到32字节对齐的目的地址
+            size_t head = ( 32 - ( reinterpret_cast<uintptr_t>( d ) & 31 ) ) & 31;
+            memmove( d, s, head );
+            d += head;
+            s += head;
+            bytes -= head;
+            for( ; bytes >= 128; bytes -= 128, d += 128, s += 128 )
+            {
+                __m256i a = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s ) );
+                __m256i b = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 32 ) );
+                __m256i c = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 64 ) );
+                __m256i e = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 96 ) );
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( d ), a );
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( d + 32 ), b );
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( d + 64 ), c );
+                _mm256_stream_si256( reinterpret_cast<__m256i*>( d + 96 ), e );
+            }
+            _mm_sfence();
+        }
+        // 每轮先全部载入再写出，dst < src的重叠也能正确处理
+        for( ; bytes >= 128; bytes -= 128, d += 128, s += 128 )
+        {
+            __m256i a = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s ) );
+            __m256i b = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 32 ) );
+            __m256i c = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 64 ) );
+            __m256i e = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 96 ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d ), a );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 32 ), b );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 64 ), c );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 96 ), e );
+        }
+        for( ; bytes >= 32; bytes -= 32, d += 32, s += 32 )
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d ),
+                                 _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s ) ) );
+        memmove( d, s, bytes );
+    }
+
+    __attribute__(( target( "avx2" ) ))
+    inline void __copy_backward_bytes_avx2( void* dst_end, const void* src_end, size_t bytes )
+    {
+        char* d = static_cast<char*>( dst_end );
+        const char* s = static_cast<const char*>( src_end );
+        // 从尾端往前，每轮先全部载入再写出，dst > src的重叠也能正确处理
+        for( ; bytes >= 128; bytes -= 128 )
+        {
+            d -= 128;
+            s -= 128;
+            __m256i a = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s ) );
+            __m256i b = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 32 ) );
+            __m256i c = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 64 ) );
+            __m256i e = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s + 96 ) );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d ), a );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 32 ), b );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 64 ), c );
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d + 96 ), e );
+        }
+        for( ; bytes >= 32; bytes -= 32 )
+        {
+            d -= 32;
+            s -= 32;
+            _mm256_storeu_si256( reinterpret_cast<__m256i*>( d ),
+                                 _mm256_loadu_si256( reinterpret_cast<const __m256i*>( s ) ) );
+        }
+        memmove( d - bytes, s - bytes, bytes );
+    }
+
+    // AVX-512，每次处理64字节
+    __attribute__(( target( "avx512f" ) ))
+    inline void __fill_bytes_avx512( void* dst, size_t bytes, const void* pattern )
+    {
+        char* d = static_cast<char*>( dst );
+        const __m512i v = _mm512_loadu_si512( pattern );
+        size_t head = ( 64 - ( reinterpret_cast<uintptr_t>( d ) & 63 ) ) & 63;
+        // 样板的周期整除32，只需检查以head % 32旋转后是否不变
+        if( bytes >= LYH_SIMD_STREAM_BYTES
+            && memcmp( pattern, static_cast<const char*>( pattern ) + ( head & 31 ), 32 ) == 0 )
+        {
+            _mm512_storeu_si512( d, v );
+            d += head;
+            bytes -= head;
+            for( ; bytes >= 256; bytes -= 256, d += 256 )
+            {
+                _mm512_stream_si512( reinterpret_cast<__m512i*>( d ), v );
+                _mm512_stream_si512( reinterpret_cast<__m512i*>( d + 64 ), v );
+                _mm512_stream_si512( reinterpret_cast<__m512i*>( d + 128 ), v );
+                _mm512_stream_si512( reinterpret_cast<__m512i*>( d + 192 ), v );
+            }
+            _mm_sfence();
+        }
+        for( ; bytes >= 256; bytes -= 256, d += 256 )
+        {
+            _mm512_storeu_si512( d, v );
+            _mm512_storeu_si512( d + 64, v );
+            _mm512_storeu_si512( d + 128, v );
+            _mm512_storeu_si512( d + 192, v );
+        }
+        for( ; bytes >= 64; bytes -= 64, d += 64 )
+            _mm512_storeu_si512( d, v );
+        memcpy( d, pattern, bytes );
+    }
+
+    __attribute__(( target( "avx512f" ) ))
+    inline void __copy_bytes_avx512( void* dst, const void* src, size_t bytes )
+    {
+        char* d = static_cast<char*>( dst );
+        const char* s = static_cast<const char*>( src );
+        if( bytes >= LYH_SIMD_STREAM_BYTES && __simd_disjoint( d, s, bytes ) )
+        {
+            size_t head = ( 64 - ( reinterpret_cast<uintptr_t>( d ) & 63 ) ) & 63;
+            memmove( d, s, head );
+            d += head;
+            s += head;
+            bytes -= head;
+            for( ; bytes >= 256; bytes -= 256, d += 256, s += 256 )
+            {
+                __m512i a = _mm512_loadu_si512( s );
+                __m512i b = _mm512_loadu_si512( s + 64 );
+                __m512i c = _mm512_loadu_si512( s + 128 );
+                __m512i e = _mm512_loadu_si512( s + 192 );
+                _mm512_stream_si512( reinterpret_cast<__m512i*>( d ), a );
+                _mm512_stream_si512( reinterpret_cast<__m512i*>( d + 64 ), b );
+                _mm512_stream_si512( reinterpret_cast<__m512i*>( d + 128 ), c );
+                _mm512_stream_si512( reinterpret_cast<__m512i*>( d + 192 ), e );
+            }
+            _mm_sfence();
+        }
+        for( ; bytes >= 256; bytes -= 256, d += 256, s += 256 )
+        {
+            __m512i a = _mm512_loadu_si512( s );
+            __m512i b = _mm512_loadu_si512( s + 64 );
+            __m512i c = _mm512_loadu_si512( s + 128 );
+            __m512i e = _mm512_loadu_si512( s + 192 );
+            _mm512_storeu_si512( d, a );
+            _mm512_storeu_si512( d + 64, b );
+            _mm512_storeu_si512( d + 128, c );
+            _mm512_storeu_si512( d + 192, e );
+        }
+        for( ; bytes >= 64; bytes -= 64, d += 64, s += 64 )
+            _mm512_storeu_si512( d, _mm512_loadu_si512( s ) );
+        memmove( d, s, bytes );
+    }
+
+    __attribute__(( target( "avx512f" ) ))
+    inline void __copy_backward_bytes_avx512( void* dst_end, const void* src_end, size_t bytes )
+    {
+        char* d = static_cast<char*>( dst_end );
+        const char* s = static_cast<const char*>( src_end );
+        for( ; bytes >= 256; bytes -= 256 )
+        {
+            d -= 256;
+            s -= 256;
+            __m512i a = _mm512_loadu_si512( s );
+            __m512i b = _mm512_loadu_si512( s + 64 );
+            __m512i c = _mm512_loadu_si512( s + 128 );
+            __m512i e = _mm512_loadu_si512( s + 192 );
+            _mm512_storeu_si512( d, a );
+            _mm512_storeu_si512( d + 64, b );
+            _mm512_storeu_si512( d + 128, c );
+            _mm512_storeu_si512( d + 192, e );
+        }
+        for( ; bytes >= 64; bytes -= 64 )
+        {
+            d -= 64;
+            s -= 64;
+            _mm512_storeu_si512( d, _mm512_loadu_si512( s ) );
+        }
+        memmove( d - bytes, s - bytes, bytes );
+    }
+#endif // __LYH_SIMD_X86
+
+    // 执行期依CPU能力挑选核心
+    inline __simd_kernels __simd_select()
+    {
+        __simd_kernels k = { __fill_bytes_scalar, __copy_bytes_scalar, __copy_backward_bytes_scalar, "scalar" };
+#ifdef __LYH_SIMD_X86
+        __builtin_cpu_init();
+        if( __builtin_cpu_supports( "avx512f" ) )
+        {
+            k.fill = __fill_bytes_avx512;
+            k.copy = __copy_bytes_avx512;
+            k.copy_backward = __copy_backward_bytes_avx512;
+            k.name = "avx512";
+        }
+        else if( __builtin_cpu_supports( "avx2" ) )
+        {
+            k.fill = __fill_bytes_avx2;
+            k.copy = __copy_bytes_avx2;
+            k.copy_backward = __copy_backward_bytes_avx2;
+            k.name = "avx2";
+        }
+#endif
+        return k;
+    }
+
+    // 第一次使用时挑选，之后直接查表
+    inline const __simd_kernels& __simd_dispatch()
+    {
+        static const __simd_kernels kernels = __simd_select();
+        return kernels;
+    }
+
+    inline void __simd_fill_bytes( void* dst, size_t bytes, const void* pattern )
+    {
+        __simd_dispatch().fill( dst, bytes, pattern );
+    }
+    // 空区间的指针可能是空指针，不能交给memmove
+    inline void __simd_copy_bytes( void* dst, const void* src, size_t bytes )
+    {
+        if( bytes != 0 )
+            __simd_dispatch().copy( dst, src, bytes );
+    }
+    inline void __simd_copy_backward_bytes( void* dst_end, const void* src_end, size_t bytes )
+    {
+        if( bytes != 0 )
+            __simd_dispatch().copy_backward( dst_end, src_end, bytes );
+    }
+}
+
+#endif //SEQUENCE_CONTAINERS_SIMD_KERNELS_H
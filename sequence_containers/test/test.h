@@ -0,0 +1,44 @@
+//
+// 单元测试共用的检查工具
+//
+
+#ifndef SEQUENCE_CONTAINERS_TEST_H
+#define SEQUENCE_CONTAINERS_TEST_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// 条件不成立时印出位置并以非0结束，不受NDEBUG影响，Release建构下同样检查
+#define TEST_CHECK( cond )                                                                  \
+    do                                                                                      \
+    {                                                                                       \
+        if( !( cond ) )                                                                     \
+        {                                                                                   \
+            std::fprintf( stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond ); \
+            std::exit( 1 );                                                                 \
+        }                                                                                   \
+    } while( 0 )
+
+// 两个容器的元素逐个相等，正向与反向各走一次(检查双向迭代器的连接)
+// c是待测的容器，不一定有const_iterator；s是作为对照的std容器
+template <class C, class S>
+void test_same( C& c, const S& s )
+{
+    TEST_CHECK( c.size() == s.size() );
+    typename C::iterator it = c.begin();
+    for( typename S::const_iterator j = s.begin(); j != s.end(); ++j, ++it )
+    {
+        TEST_CHECK( it != c.end() );
+        TEST_CHECK( *it == *j );
+    }
+    TEST_CHECK( it == c.end() );
+    typename S::const_reverse_iterator r = s.rbegin();
+    for( ; r != s.rend(); ++r )
+    {
+        --it;
+        TEST_CHECK( *it == *r );
+    }
+    TEST_CHECK( it == c.begin() );
+}
+
+#endif //SEQUENCE_CONTAINERS_TEST_H
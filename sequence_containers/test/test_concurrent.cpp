@@ -0,0 +1,339 @@
+//
+// 并行容器：spsc_ring、work_stealing_deque、concurrent_vector
+// 多线程的部分检查每个元素恰好出现一次，次序符合各容器的保证
+//
+
+#include "concurrent_containers.h"
+#include "test/test.h"
+#include <atomic>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+void test_spsc_ring()
+{
+    {
+        // 容量取整到缓冲区的倍数
+        spsc_ring<std::string, alloc, 3> r( 10 );
+        TEST_CHECK( r.capacity() == 12 );
+        std::string s;
+        for( int i = 0; i < 12; ++i )
+            TEST_CHECK( r.push( std::to_string( i ) ) );
+        TEST_CHECK( !r.push( "x" ) );
+        for( int i = 0; i < 5; ++i )
+            TEST_CHECK( r.pop( s ) && s == std::to_string( i ) );
+        std::string in[7];
+        for( int i = 0; i < 7; ++i )
+            in[i] = "b" + std::to_string( i );
+        TEST_CHECK( r.push( in, 7 ) == 5 );
+        std::string out[20];
+        TEST_CHECK( r.pop( out, 20 ) == 12 );
+        TEST_CHECK( out[6] == "11" && out[7] == "b0" && out[11] == "b4" );
+        TEST_CHECK( !r.pop( s ) && r.empty() );
+        r.push( "left" );   // 解构时仍有元素
+    }
+    {
+        spsc_ring<int, alloc, 0, deque_buffer_policy<512, 1, 0, true> > r( 1000 );
+        for( int i = 0; i < 500; ++i )
+            TEST_CHECK( r.push( i ) );
+        int v;
+        for( int i = 0; i < 500; ++i )
+            TEST_CHECK( r.pop( v ) && v == i );
+    }
+    {
+        // 一个生产者、一个消费者，单个与成批的push、pop交错
+        const long n = 200000;
+        spsc_ring<long> r( 1000 );
+        std::thread producer( [&]
+        {
+            long buf[37];
+            for( long i = 0; i < n; )
+            {
+                if( i % 3 == 0 )
+                {
+                    long k = 0;
+                    for( ; k < 37 && i + k < n; ++k )
+                        buf[k] = i + k;
+                    i += long( r.push( buf, size_t( k ) ) );
+                }
+                else if( r.push( i ) )
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        } );
+        long expect = 0;
+        long out[50];
+        while( expect < n )
+        {
+            long v;
+            if( expect % 2 )
+            {
+                if( r.pop( v ) )
+                {
+                    TEST_CHECK( v == expect );
+                    ++expect;
+                }
+                else
+                    std::this_thread::yield();
+            }
+            else
+            {
+                long k = long( r.pop( out, 50 ) );
+                for( long j = 0; j < k; ++j )
+                    TEST_CHECK( out[j] == expect + j );
+                expect += k;
+                if( k == 0 )
+                    std::this_thread::yield();
+            }
+        }
+        producer.join();
+        TEST_CHECK( r.empty() );
+    }
+}
+
+void test_work_stealing_deque()
+{
+    {
+        // 单线程：拥有者LIFO，窃取者FIFO，map随之成长
+        work_stealing_deque<long, alloc> q( 2 );
+        for( long i = 0; i < 100000; ++i )
+            q.push( i );
+        long v;
+        for( long i = 99999; i >= 50000; --i )
+            TEST_CHECK( q.pop( v ) && v == i );
+        for( long i = 0; i < 50000; ++i )
+            TEST_CHECK( q.steal( v ) && v == i );
+        TEST_CHECK( !q.pop( v ) && !q.steal( v ) && q.empty() );
+    }
+    {
+        // 拥有者push与pop，三个窃取者同时steal，每个元素恰好取出一次
+        const int n = 100000;
+        work_stealing_deque<int> q( 1 );
+        std::vector< std::atomic<int> > seen( n + 1 );
+        for( size_t i = 0; i < seen.size(); ++i )
+            seen[i].store( 0 );
+        std::atomic<bool> done( false );
+        std::vector<std::thread> thieves;
+        for( int k = 0; k < 3; ++k )
+            thieves.push_back( std::thread( [&]
+            {
+                int x;
+                while( !done.load() || !q.empty() )
+                    if( q.steal( x ) )
+                        seen[x].fetch_add( 1 );
+            } ) );
+        int x;
+        for( int i = 1; i <= n; ++i )
+        {
+            q.push( i );
+            if( i % 3 == 0 && q.pop( x ) )
+                seen[x].fetch_add( 1 );
+        }
+        while( q.pop( x ) )
+            seen[x].fetch_add( 1 );
+        done.store( true );
+        for( size_t k = 0; k < thieves.size(); ++k )
+            thieves[k].join();
+        for( int i = 1; i <= n; ++i )
+            TEST_CHECK( seen[i].load() == 1 );
+    }
+}
+
+// 第n次复制时抛出异常，live记录存活的个数
+struct thrower
+{
+    static std::atomic<int> n, live;
+    int v;
+    thrower() : v( -1 ) { ++live; }
+    thrower( const thrower& x ) : v( x.v ) { if( ++n % 7 == 0 ) throw 1; ++live; }
+    ~thrower() { --live; }
+    thrower& operator=( const thrower& x ) { v = x.v; return *this; }
+};
+std::atomic<int> thrower::n( 0 ), thrower::live( 0 );
+
+void test_spsc_ring_exception()
+{
+    // 成批push复制到第二个缓冲区时抛出异常：已构造的元素被析构，队列不变
+    spsc_ring<thrower, alloc, 3> r( 12 );
+    thrower in[10];
+    for( int i = 0; i < 10; ++i )
+        in[i].v = i;
+    thrower::n = 2;
+    bool thrown = false;
+    try { r.push( in, 10 ); } catch( int ) { thrown = true; }
+    TEST_CHECK( thrown && r.empty() && thrower::live == 10 );
+    thrower::n = 0;
+    TEST_CHECK( r.push( in + 4, 5 ) == 5 && r.size() == 5 );
+    thrower out[5];
+    TEST_CHECK( r.pop( out, 5 ) == 5 && out[0].v == 4 && out[4].v == 8 && r.empty() );
+    TEST_CHECK( thrower::live == 15 );
+}
+
+// 没有缺省构造函数的型别
+struct no_default
+{
+    explicit no_default( int x ) : v( x ) {}
+    int v;
+};
+
+// 第fail_at次配置时抛出bad_alloc
+struct failing_alloc
+{
+    static int count, fail_at;
+    static void* allocate( size_t n )
+    {
+        if( ++count == fail_at )
+            throw std::bad_alloc();
+        return malloc( n );
+    }
+    static void deallocate( void* p, size_t ) { free( p ); }
+};
+int failing_alloc::count = 0, failing_alloc::fail_at = 0;
+
+void test_work_stealing_deque_construct()
+{
+    {
+        // map大小不是2的幂时向上取整，0视为1
+        work_stealing_deque<int, alloc, 4> q3( 3 ), q0( 0 );
+        for( int i = 0; i < 1000; ++i )
+        {
+            q3.push( i );
+            q0.push( i );
+        }
+        int x, y;
+        for( int i = 999; i >= 0; --i )
+            TEST_CHECK( q3.pop( x ) && q0.pop( y ) && x == i && y == i );
+    }
+    // 构造时每一次配置失败，都不遗留已配置的空间
+    for( int k = 1; k <= 6; ++k )
+    {
+        failing_alloc::count = 0;
+        failing_alloc::fail_at = k;
+        bool thrown = false;
+        try { work_stealing_deque<int, failing_alloc> q( 4 ); }
+        catch( std::bad_alloc& ) { thrown = true; }
+        TEST_CHECK( thrown );
+    }
+    failing_alloc::fail_at = 0;
+}
+
+void test_concurrent_vector()
+{
+    {
+        // 元素的地址在成长后不变
+        concurrent_vector<std::string> v;
+        std::vector<const std::string*> addr;
+        for( int i = 0; i < 5000; ++i )
+        {
+            TEST_CHECK( v.push_back( std::to_string( i ) ) == size_t( i ) );
+            addr.push_back( &v[i] );
+        }
+        for( int i = 0; i < 5000; ++i )
+            TEST_CHECK( &v[i] == addr[i] && v[i] == std::to_string( i ) );
+        TEST_CHECK( v.grow_by( 1000, "x" ) == 5000 && v.size() == 6000 && v[5999] == "x" );
+        v.clear();
+        TEST_CHECK( v.empty() );
+        v.push_back( "a" );
+        TEST_CHECK( v[0] == "a" && v.size() == 1 );
+        v.reserve( 100000 );
+        TEST_CHECK( v.capacity() >= 100000 );
+    }
+    {
+        concurrent_vector<no_default> v;
+        for( int i = 0; i < 100; ++i )
+            v.push_back( no_default( i ) );
+        TEST_CHECK( v.size() == 100 && v[99].v == 99 );
+    }
+    {
+        // 构造失败的位置永远不会就绪，size()停在第一个失败的位置之前
+        concurrent_vector<thrower> v;
+        thrower t;
+        t.v = 5;
+        size_t first_fail = size_t( -1 );
+        for( int i = 0; i < 100; ++i )
+        {
+            size_t before = v.size();
+            try { v.grow_by( 3, t ); }
+            catch( int )
+            {
+                if( first_fail == size_t( -1 ) )
+                    for( first_fail = before; v.ready( first_fail ); )
+                        ++first_fail;
+            }
+        }
+        TEST_CHECK( first_fail != size_t( -1 ) && v.size() == first_fail && !v.ready( first_fail ) );
+        for( size_t i = 0; i < 300; ++i )
+            if( v.ready( i ) )
+                TEST_CHECK( v[i].v == 5 );
+    }
+    {
+        // 段配置失败时，该段的位置不计入size()，clear与解构跳过它们
+        failing_alloc::count = 0;
+        failing_alloc::fail_at = 2;
+        concurrent_vector<std::string, failing_alloc> v;
+        bool thrown = false;
+        for( size_t i = 0; i < 100000 && !thrown; ++i )
+        {
+            try { v.push_back( "s" ); }
+            catch( std::bad_alloc& ) { thrown = true; }
+        }
+        TEST_CHECK( thrown );
+        const size_t n = v.size();
+        TEST_CHECK( !v.ready( n ) );
+        v.push_back( "after" );
+        TEST_CHECK( v.size() == n );
+    }
+    {
+        // 多个线程同时push_back与grow_by，另一个线程读取已就绪的前缀
+        const int threads = 4, n = 20000;
+        concurrent_vector<long> v;
+        std::atomic<bool> stop( false );
+        std::thread reader( [&]
+        {
+            while( !stop )
+            {
+                size_t size = v.size();
+                for( size_t i = size > 100 ? size - 100 : 0; i < size; ++i )
+                {
+                    long x = v[i];
+                    TEST_CHECK( x >= 0 && x % 1000000 < n );
+                }
+            }
+        } );
+        std::vector<std::thread> writers;
+        for( int t = 0; t < threads; ++t )
+            writers.push_back( std::thread( [&v, t]
+            {
+                for( int i = 0; i < n; ++i )
+                {
+                    if( i % 10 == 0 )
+                        v.grow_by( 3, long( t ) * 1000000 + i );
+                    else
+                        v.push_back( long( t ) * 1000000 + i );
+                }
+            } ) );
+        for( size_t t = 0; t < writers.size(); ++t )
+            writers[t].join();
+        stop = true;
+        reader.join();
+        TEST_CHECK( v.size() == size_t( threads ) * n + threads * ( n / 10 ) * 2 );
+        std::vector<int> count( threads * n, 0 );
+        for( size_t i = 0; i < v.size(); ++i )
+            ++count[ ( v[i] / 1000000 ) * n + v[i] % 1000000 ];
+        for( int k = 0; k < threads * n; ++k )
+            TEST_CHECK( count[k] == ( k % n % 10 == 0 ? 3 : 1 ) );
+    }
+}
+
+int main()
+{
+    test_spsc_ring();
+    test_spsc_ring_exception();
+    test_work_stealing_deque();
+    test_work_stealing_deque_construct();
+    test_concurrent_vector();
+    puts( "ok" );
+    return 0;
+}
@@ -0,0 +1,281 @@
+//
+// deque：与std::deque对照的随机操作(各种缓冲区大小、配置策略与迭代器布局)、
+// 迭代器的随机存取、分段算法
+//
+
+#include "sequence_containers.h"
+#include "test/test.h"
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef deque_buffer_policy<512, 1, 0, true> compact_buffers;
+
+// 缓冲区大小与迭代器的布局都是编译期决定的
+static_assert( deque<int>::buffer_size() == 128, "" );
+static_assert( deque<int, alloc, 48>::buffer_size() == 48, "" );
+static_assert( deque<int, alloc, 0, deque_buffer_policy<4096, 1, 0> >::buffer_size() == 1024, "" );
+static_assert( sizeof( deque<int>::iterator ) == 4 * sizeof( void* ), "" );
+static_assert( sizeof( deque<int, alloc, 0, compact_buffers>::iterator ) == 2 * sizeof( void* ), "" );
+static_assert( LYH::__is_random_access_iterator<deque<int>::iterator>::value, "" );
+static_assert( !LYH::__is_contiguous_iterator<deque<int>::iterator>::value, "" );
+
+int make_int( int x ) { return x; }
+std::string make_string( int x ) { return std::string( x % 40 + 1, char( 'a' + x % 26 ) ); }
+char make_char( int x ) { return char( x ); }
+
+// 逐个元素、以下标、反向各比较一次
+template <class D, class S>
+void check_equal( D& d, const S& s )
+{
+    test_same( d, s );
+    for( size_t j = 0; j < s.size(); ++j )
+        TEST_CHECK( d[j] == s[j] );
+    if( !s.empty() )
+        TEST_CHECK( d.front() == s.front() && d.back() == s.back() );
+}
+
+template <class V, size_t B, class P>
+void run_against_std( unsigned seed, V ( *make )( int ) )
+{
+    typedef deque<V, alloc, B, P> D;
+    std::mt19937 g( seed );
+    D d;
+    std::deque<V> s;
+    for( int step = 0; step < 20000; ++step )
+    {
+        V v = make( int( g() % 1000 ) );
+        switch( g() % 12 )
+        {
+        case 0: case 1:
+            d.push_back( v );
+            s.push_back( v );
+            break;
+        case 2: case 3:
+            d.push_front( v );
+            s.push_front( v );
+            break;
+        case 4:
+            if( !s.empty() ) { d.pop_back(); s.pop_back(); }
+            break;
+        case 5:
+            if( !s.empty() ) { d.pop_front(); s.pop_front(); }
+            break;
+        case 6:
+        {
+            size_t p = s.empty() ? 0 : g() % ( s.size() + 1 );
+            typename D::iterator r = d.insert( d.begin() + p, v );
+            s.insert( s.begin() + p, v );
+            TEST_CHECK( *r == v && size_t( r - d.begin() ) == p );
+            break;
+        }
+        case 7:
+            if( !s.empty() )
+            {
+                size_t p = g() % s.size();
+                typename D::iterator r = d.erase( d.begin() + p );
+                s.erase( s.begin() + p );
+                TEST_CHECK( size_t( r - d.begin() ) == p );
+            }
+            break;
+        case 8:
+        {
+            size_t p = g() % ( s.size() + 1 ), n = 1 + g() % 40;
+            d.insert( d.begin() + p, n, v );
+            s.insert( s.begin() + p, n, v );
+            break;
+        }
+        case 9:
+            if( !s.empty() )
+            {
+                size_t a = g() % s.size(), b = a + g() % ( s.size() - a + 1 );
+                typename D::iterator r = d.erase( d.begin() + a, d.begin() + b );
+                s.erase( s.begin() + a, s.begin() + b );
+                TEST_CHECK( size_t( r - d.begin() ) == a );
+            }
+            break;
+        case 10:
+            if( g() % 50 == 0 )
+            {
+                d.clear();
+                s.clear();
+            }
+            else if( !s.empty() )
+            {
+                // 插入自身的元素
+                size_t p = g() % ( s.size() + 1 ), q = g() % s.size();
+                V x = s[q];
+                d.insert( d.begin() + p, d[q] );
+                s.insert( s.begin() + p, x );
+            }
+            break;
+        case 11:
+            if( g() % 20 == 0 )
+            {
+                size_t n = g() % 300;
+                d.resize( n, v );
+                s.resize( n, v );
+            }
+            break;
+        }
+        if( step % 500 == 0 )
+            check_equal( d, s );
+    }
+    check_equal( d, s );
+    if( P::align )
+        for( typename D::iterator it = d.begin(); it != d.end(); ++it )
+            TEST_CHECK( size_t( it.buf_first() ) % P::align == 0 );
+    D c( d );
+    check_equal( c, s );
+    D e;
+    e = c;
+    check_equal( e, s );
+    const D& cr = c;
+    size_t k = 0;
+    for( typename D::const_iterator it = cr.begin(); it != cr.end(); ++it )
+        TEST_CHECK( *it == s[k++] );
+}
+
+// 迭代器的+=、-、[]在每个位置、往两个方向跳跃各种距离
+template <class D>
+void check_iterator_arithmetic()
+{
+    D d;
+    for( long i = 0; i < 3000; ++i )
+        d.push_back( i );
+    for( long i = 1; i <= 500; ++i )
+        d.push_front( -i );
+    typename D::iterator b = d.begin(), e = d.end();
+    const long n = e - b;
+    TEST_CHECK( n == 3500 );
+    for( long i = 0; i < n; i += 7 )
+    {
+        typename D::iterator it = b + i;
+        TEST_CHECK( *it == i - 500 && it - b == i && e - it == n - i );
+        for( long j = -i; j < n - i; j += 13 )
+        {
+            TEST_CHECK( it[j] == i + j - 500 );
+            typename D::iterator k = it;
+            k += j;
+            TEST_CHECK( *k == i + j - 500 && k - it == j );
+            k -= j;
+            TEST_CHECK( k == it );
+        }
+    }
+}
+
+// 分段算法与std的算法对照，区间的头尾落在缓冲区中的任意位置
+template <size_t B, class V, class P>
+void check_segmented( std::mt19937& g, V ( *make )( int ) )
+{
+    typedef deque<V, alloc, B, P> D;
+    for( int trial = 0; trial < 300; ++trial )
+    {
+        D d;
+        std::vector<V> v;
+        const int n = int( g() % 100 ), f = int( g() % 30 );
+        for( int i = 0; i < n; ++i )
+            d.push_back( make( i * 7 ) );
+        for( int i = 0; i < f; ++i )
+            d.push_front( make( 1000 + i ) );
+        for( typename D::iterator it = d.begin(); it != d.end(); ++it )
+            v.push_back( *it );
+        const size_t a = g() % ( v.size() + 1 ), b = a + g() % ( v.size() - a + 1 );
+
+        size_t count = 0;
+        LYH::for_each( d.begin() + a, d.begin() + b, [&]( const V& ) { ++count; } );
+        TEST_CHECK( count == b - a );
+        if( b > a )
+        {
+            size_t k = a + g() % ( b - a );
+            typename D::iterator it = LYH::find( d.begin() + a, d.begin() + b, v[k] );
+            TEST_CHECK( it - d.begin() == std::find( v.begin() + a, v.begin() + b, v[k] ) - v.begin() );
+        }
+        TEST_CHECK( LYH::find( d.begin() + a, d.begin() + b, make( 99999 ) ) == d.begin() + b );
+
+        // deque到指针、deque到deque、copy_backward、指针到deque
+        std::vector<V> out( b - a );
+        V* e = LYH::copy( d.begin() + a, d.begin() + b, out.data() );
+        TEST_CHECK( e == out.data() + ( b - a ) );
+        for( size_t i = 0; i < b - a; ++i )
+            TEST_CHECK( out[i] == v[a + i] );
+        const size_t off = g() % 8;
+        D d2( v.size() + 7, make( 5 ) );
+        TEST_CHECK( LYH::copy( d.begin() + a, d.begin() + b, d2.begin() + off ) == d2.begin() + off + ( b - a ) );
+        for( size_t i = 0; i < b - a; ++i )
+            TEST_CHECK( d2[off + i] == v[a + i] );
+        D d3( v.size() + 7, make( 5 ) );
+        TEST_CHECK( LYH::copy_backward( d.begin() + a, d.begin() + b, d3.begin() + off + ( b - a ) ) == d3.begin() + off );
+        for( size_t i = 0; i < b - a; ++i )
+            TEST_CHECK( d3[off + i] == v[a + i] );
+        const V* cf = out.data();
+        TEST_CHECK( LYH::copy( cf, cf + out.size(), d3.begin() ) == d3.begin() + out.size() );
+        for( size_t i = 0; i < out.size(); ++i )
+            TEST_CHECK( d3[i] == out[i] );
+
+        LYH::fill( d2.begin() + a, d2.begin() + b, make( 77 ) );
+        for( size_t i = a; i < b; ++i )
+            TEST_CHECK( d2[i] == make( 77 ) );
+        const D& cd = d;
+        D d4( cd );
+        check_equal( d4, v );
+    }
+}
+
+void test_segmented_numeric()
+{
+    deque<int, alloc, 5> d;
+    for( int i = 0; i < 100; ++i )
+        d.push_back( i );
+    TEST_CHECK( LYH::accumulate( d.begin() + 3, d.end(), 0 ) == 4950 - 3 );
+    TEST_CHECK( LYH::accumulate( d.begin(), d.end(), 0L, []( long a, int b ) { return a + b * 2; } ) == 9900 );
+    // 填充值的型别与元素不同时先转换
+    deque<long> l( 5000, 1 );
+    LYH::fill( l.begin() + 3, l.end(), 0 );
+    for( size_t i = 3; i < l.size(); ++i )
+        TEST_CHECK( l[i] == 0 );
+    deque<short> s( 300, 1 );
+    LYH::fill( s.begin(), s.end(), 70000 );
+    for( size_t i = 0; i < s.size(); ++i )
+        TEST_CHECK( s[i] == short( 70000 ) );
+    deque<char> c;
+    for( int i = 0; i < 2000; ++i )
+        c.push_back( char( 'a' + i % 20 ) );
+    c.push_back( 'z' );
+    TEST_CHECK( LYH::find( c.begin(), c.end(), 'z' ) - c.begin() == 2000 );
+}
+
+int main()
+{
+    typedef deque_buffer_policy<> sgi;
+    run_against_std<int, 0, sgi>( 1, make_int );
+    run_against_std<int, 3, sgi>( 2, make_int );
+    run_against_std<std::string, 0, sgi>( 3, make_string );
+    run_against_std<std::string, 1, sgi>( 4, make_string );
+    run_against_std<std::string, 5, sgi>( 5, make_string );
+    run_against_std<char, 0, sgi>( 6, make_char );
+    run_against_std<int, 0, deque_cache_buffers>( 7, make_int );
+    run_against_std<std::string, 0, deque_page_buffers>( 8, make_string );
+    run_against_std<char, 0, deque_buffer_policy<16, 4, 16> >( 9, make_char );
+    run_against_std<int, 0, compact_buffers>( 10, make_int );
+    run_against_std<std::string, 3, compact_buffers>( 11, make_string );
+
+    check_iterator_arithmetic< deque<long> >();
+    check_iterator_arithmetic< deque<long, alloc, 48> >();
+    check_iterator_arithmetic< deque<long, alloc, 1> >();
+    check_iterator_arithmetic< deque<int, alloc, 3> >();
+    check_iterator_arithmetic< deque<long, alloc, 0, compact_buffers> >();
+    check_iterator_arithmetic< deque<long, alloc, 3, compact_buffers> >();
+
+    std::mt19937 g( 3 );
+    check_segmented<1, int, sgi>( g, make_int );
+    check_segmented<3, int, sgi>( g, make_int );
+    check_segmented<0, int, sgi>( g, make_int );
+    check_segmented<7, std::string, sgi>( g, make_string );
+    check_segmented<0, std::string, sgi>( g, make_string );
+    check_segmented<3, int, compact_buffers>( g, make_int );
+    test_segmented_numeric();
+    puts( "ok" );
+    return 0;
+}
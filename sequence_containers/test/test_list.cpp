@@ -0,0 +1,544 @@
+//
+// list、unrolled_list与intrusive_list：与std::list对照的随机操作、复制、
+// 稳定排序(含平行排序)、节点缓存、预取、成批删除
+//
+
+// 门槛调低，小的输入也走过并行排序与收集排序的路径
+#define LYH_LIST_PARALLEL_SORT_MIN 64
+#define LYH_LIST_GATHER_SORT_MIN 32
+
+#include "sequence_containers.h"
+#include "test/test.h"
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+struct keyed
+{
+    int k, id;
+    bool operator<( const keyed& x ) const { return k < x.k; }
+};
+
+int make_int( int v ) { return v; }
+std::string make_string( int v ) { return std::string( v % 3 ? 30 : 2, char( 'a' + v % 26 ) ) + std::to_string( v ); }
+
+// 走到第k个位置，两个容器各一个迭代器
+template <class I, class J>
+void advance_both( I& a, J& b, size_t k )
+{
+    for( size_t i = 0; i < k; ++i )
+    {
+        ++a;
+        ++b;
+    }
+}
+
+// 在a之前插入x，传回指向新元素的迭代器
+template <class L, class T>
+typename L::iterator insert_at( L& u, typename L::iterator a, const T& x )
+{
+    return u.insert( a, x );
+}
+// list的insert不是公开的介面，先放进暂时的list再splice过去
+template <class T, class Alloc>
+typename list<T, Alloc>::iterator insert_at( list<T, Alloc>& u, typename list<T, Alloc>::iterator a, const T& x )
+{
+    list<T, Alloc> tmp;
+    tmp.push_back( x );
+    typename list<T, Alloc>::iterator r = tmp.begin();
+    u.splice( a, tmp );
+    return r;
+}
+
+// 对待测的链表L与std::list做同样的随机操作，每一步之后比较内容
+template <class L, class T>
+void run_against_std( unsigned seed, T ( *make )( int ) )
+{
+    std::mt19937 g( seed );
+    L u;
+    std::list<T> s;
+    for( int step = 0; step < 20000; ++step )
+    {
+        const int v = int( g() % 50 );
+        switch( g() % 14 )
+        {
+        case 0: case 1:
+            u.push_back( make( v ) );
+            s.push_back( make( v ) );
+            break;
+        case 2:
+            u.push_front( make( v ) );
+            s.push_front( make( v ) );
+            break;
+        case 3:
+            if( !s.empty() ) { u.pop_back(); s.pop_back(); }
+            break;
+        case 4:
+            if( !s.empty() ) { u.pop_front(); s.pop_front(); }
+            break;
+        case 5:
+        {
+            typename L::iterator a = u.begin();
+            typename std::list<T>::iterator b = s.begin();
+            advance_both( a, b, s.empty() ? 0 : g() % ( s.size() + 1 ) );
+            a = insert_at( u, a, make( v ) );
+            b = s.insert( b, make( v ) );
+            TEST_CHECK( *a == *b );
+            break;
+        }
+        case 6:
+            if( !s.empty() )
+            {
+                typename L::iterator a = u.begin();
+                typename std::list<T>::iterator b = s.begin();
+                advance_both( a, b, g() % s.size() );
+                a = u.erase( a );
+                b = s.erase( b );
+                TEST_CHECK( ( a == u.end() ) == ( b == s.end() ) );
+            }
+            break;
+        case 7:
+            if( g() % 20 == 0 ) { u.remove( make( v ) ); s.remove( make( v ) ); }
+            break;
+        case 8:
+            if( g() % 20 == 0 ) { u.unique(); s.unique(); }
+            break;
+        case 9:
+            if( g() % 30 == 0 ) { u.sort(); s.sort(); }
+            break;
+        case 10:
+            if( g() % 30 == 0 ) { u.reverse(); s.reverse(); }
+            break;
+        case 11:
+        {
+            L u2;
+            std::list<T> s2;
+            const int n = int( g() % 40 );
+            for( int i = 0; i < n; ++i )
+            {
+                T x = make( int( g() % 50 ) );
+                u2.push_back( x );
+                s2.push_back( x );
+            }
+            if( g() % 2 )
+            {
+                u.sort(); s.sort(); u2.sort(); s2.sort();
+                u.merge( u2 );
+                s.merge( s2 );
+                TEST_CHECK( u2.empty() && u2.size() == 0 );
+            }
+            else
+            {
+                typename L::iterator a = u.begin();
+                typename std::list<T>::iterator b = s.begin();
+                advance_both( a, b, s.empty() ? 0 : g() % ( s.size() + 1 ) );
+                if( g() % 2 || n == 0 )
+                {
+                    u.splice( a, u2 );
+                    s.splice( b, s2 );
+                }
+                else
+                {
+                    size_t f = g() % n, l = f + g() % ( n - f + 1 );
+                    typename L::iterator a1 = u2.begin(), a2 = u2.begin();
+                    typename std::list<T>::iterator b1 = s2.begin(), b2 = s2.begin();
+                    advance_both( a1, b1, f );
+                    advance_both( a2, b2, l );
+                    u.splice( a, u2, a1, a2 );
+                    s.splice( b, s2, b1, b2 );
+                    test_same( u2, s2 );
+                }
+            }
+            break;
+        }
+        case 12:
+            if( s.size() > 2 )
+            {
+                typename L::iterator a = u.begin(), ai = u.begin();
+                typename std::list<T>::iterator b = s.begin(), bi = s.begin();
+                advance_both( a, b, g() % ( s.size() + 1 ) );
+                advance_both( ai, bi, g() % s.size() );
+                u.splice( a, u, ai );
+                s.splice( b, s, bi );
+            }
+            break;
+        case 13:
+            if( g() % 50 == 0 )
+            {
+                L c( u );
+                test_same( c, s );
+                c = u;
+                test_same( c, s );
+                u.swap( c );
+                if( g() % 3 == 0 ) { u.clear(); s.clear(); }
+            }
+            break;
+        }
+        test_same( u, s );
+    }
+}
+
+void test_copy()
+{
+    list<std::string> s;
+    for( int i = 0; i < 5; ++i )
+        s.push_back( std::to_string( i ) );
+    s.reserve_nodes( 8 );
+    list<std::string> t( s );   // 复制内容，不复制节点缓存
+    TEST_CHECK( t.size() == 5 && t.node_cache_size() == 0 && t.back() == "4" );
+    list<std::string> u;
+    u.push_back( "x" );
+    u = s;
+    TEST_CHECK( u.size() == 5 && u.front() == "0" );
+    list<std::string> v;
+    v = u;
+    v.pop_back();
+    u = v;
+    TEST_CHECK( u.size() == 4 && u.back() == "3" );
+    u = u;
+    TEST_CHECK( u.size() == 4 );
+    list<std::string> e;
+    u = e;
+    TEST_CHECK( u.empty() );
+}
+
+// 排序的结果与std::list::sort相同，相等的键保持原来的次序
+template <class L>
+void check_sorted( L& l, const std::list<keyed>& s )
+{
+    TEST_CHECK( l.size() == s.size() );
+    std::list<keyed>::const_iterator j = s.begin();
+    for( typename L::iterator i = l.begin(); i != l.end(); ++i, ++j )
+        TEST_CHECK( i->id == j->id );
+    size_t c = 0;
+    for( typename L::iterator it = l.end(); it != l.begin(); ++c )
+        --it;
+    TEST_CHECK( c == s.size() );
+}
+
+void test_sort()
+{
+    std::mt19937 g( 1 );
+    thread_pool pool( 4 );
+    const int sizes[] = { 0, 1, 5, 100, 4095, 4096, 20000 };
+    for( int n : sizes )
+    {
+        list<keyed> l;
+        std::list<keyed> s;
+        for( int i = 0; i < n; ++i )
+        {
+            keyed k = { int( g() % 50 ), i };
+            l.push_back( k );
+            s.push_back( k );
+        }
+        list<keyed> p( l );
+        l.sort();
+        p.sort( pool );
+        s.sort();
+        check_sorted( l, s );
+        check_sorted( p, s );
+        auto greater = []( const keyed& a, const keyed& b ) { return b < a; };
+        l.sort( greater );
+        p.sort( pool, greater );
+        s.sort( greater );
+        check_sorted( l, s );
+        check_sorted( p, s );
+    }
+
+    // 比较函数抛出异常时节点一个不少
+    list<int> l;
+    for( int i = 0; i < 5000; ++i )
+        l.push_back( int( g() % 100 ) );
+    int count = 0;
+    bool thrown = false;
+    try { l.sort( pool, [&]( int a, int b ) { if( ++count == 20000 ) throw 1; return a < b; } ); }
+    catch( int ) { thrown = true; }
+    TEST_CHECK( thrown && l.size() == 5000 );
+    size_t c = 0;
+    for( list<int>::iterator it = l.begin(); it != l.end(); ++it )
+        ++c;
+    TEST_CHECK( c == 5000 );
+}
+
+void test_node_cache()
+{
+    list<std::string> l;
+    l.reserve_nodes( 100 );
+    TEST_CHECK( l.node_cache_size() == 100 );
+    for( int i = 0; i < 100; ++i )
+        l.push_back( std::to_string( i ) );
+    TEST_CHECK( l.node_cache_size() == 0 );
+    for( int r = 0; r < 1000; ++r )
+    {
+        l.pop_front();
+        l.push_back( "x" );
+        TEST_CHECK( l.node_cache_size() <= 1 );
+    }
+    l.clear();
+    TEST_CHECK( l.node_cache_size() == 100 );
+    l.set_node_cache_limit( 10 );
+    TEST_CHECK( l.node_cache_size() == 10 );
+    l.set_node_cache_limit( 0 );
+    TEST_CHECK( l.node_cache_size() == 0 );
+}
+
+void test_remove_if()
+{
+    std::mt19937 g( 7 );
+    list<std::string> l;
+    std::list<std::string> s;
+    for( int i = 0; i < 5000; ++i )
+    {
+        std::string v = std::to_string( g() % 30 );
+        l.push_back( v );
+        s.push_back( v );
+    }
+    auto one_digit = []( const std::string& x ) { return x.size() == 1; };
+    const size_t before = s.size();
+    const size_t n = l.remove_if( one_digit );
+    s.remove_if( one_digit );
+    TEST_CHECK( n == before - s.size() );
+    test_same( l, s );
+    TEST_CHECK( erase_if( l, []( const std::string& ) { return true; } ) == s.size() && l.empty() );
+
+    // 谓词抛出异常时，已判定删除的节点照常删除
+    int c = 0;
+    l.push_back( "a" );
+    l.push_back( "b" );
+    l.push_back( "c" );
+    try { l.remove_if( [&]( const std::string& x ) { if( ++c == 3 ) throw 1; return x == "a"; } ); }
+    catch( int ) {}
+    TEST_CHECK( l.size() == 2 && l.front() == "b" );
+
+    // 删除的节点先回到节点缓存
+    list<int> m;
+    m.set_node_cache_limit( 10 );
+    for( int i = 0; i < 100; ++i )
+        m.push_back( i );
+    TEST_CHECK( m.remove_if( []( int x ) { return x % 2; } ) == 50 );
+    TEST_CHECK( m.node_cache_size() == 10 && m.size() == 50 );
+
+    thread_pool pool( 2 );
+    list<std::string, threaded_alloc> t;
+    for( int i = 0; i < 20000; ++i )
+        t.push_back( std::string( 40, char( 'a' + i % 26 ) ) );
+    TEST_CHECK( t.remove_if( []( const std::string& x ) { return x[0] == 'a'; }, pool ) == 770 );
+    TEST_CHECK( t.size() == 20000 - 770 );
+}
+
+void test_prefetch()
+{
+    std::mt19937 g( 5 );
+    const size_t distances[] = { 0, 1, 4, 16 };
+    for( size_t k : distances )
+    {
+        set_list_prefetch_distance( k );
+        list<int> l;
+        std::list<int> s;
+        for( int i = 0; i < 3000; ++i )
+        {
+            int v = int( g() % 20 );
+            l.push_back( v );
+            s.push_back( v );
+        }
+        l.remove( 3 );
+        s.remove( 3 );
+        l.unique();
+        s.unique();
+        test_same( l, s );
+        long sum = 0;
+        LYH::for_each( l.begin(), l.end(), [&]( int x ) { sum += x; } );
+        long expect = 0;
+        for( int x : s )
+            expect += x;
+        TEST_CHECK( sum == expect );
+    }
+    set_list_prefetch_distance( LYH_LIST_PREFETCH_DISTANCE );
+}
+
+// 第n次复制时抛出异常
+struct thrower
+{
+    static int n;
+    int v;
+    thrower( int x = 0 ) : v( x ) {}
+    thrower( const thrower& x ) : v( x.v ) { if( n && --n == 0 ) throw 1; }
+    thrower& operator=( const thrower& x ) { v = x.v; return *this; }
+};
+int thrower::n = 0;
+
+void test_unrolled_list()
+{
+    // 自订比较的排序与合并
+    std::mt19937 g( 9 );
+    unrolled_list<int, alloc, 4> a, b;
+    std::list<int> sa, sb;
+    for( int i = 0; i < 500; ++i )
+    {
+        int x = int( g() % 100 ), y = int( g() % 100 );
+        a.push_back( x );
+        sa.push_back( x );
+        b.push_back( y );
+        sb.push_back( y );
+    }
+    auto greater = []( int x, int y ) { return y < x; };
+    a.sort( greater );
+    sa.sort( greater );
+    b.sort( greater );
+    sb.sort( greater );
+    test_same( a, sa );
+    a.merge( b, greater );
+    sa.merge( sb, greater );
+    test_same( a, sa );
+    TEST_CHECK( b.empty() );
+
+    // 复制中途抛出异常：复制构造不留下节点，插入失败时size不变
+    unrolled_list<thrower, alloc, 3> t;
+    for( int i = 0; i < 20; ++i )
+        t.push_back( thrower( i ) );
+    bool thrown = false;
+    thrower::n = 10;
+    try { unrolled_list<thrower, alloc, 3> c( t ); } catch( int ) { thrown = true; }
+    TEST_CHECK( thrown );
+    for( int k = 1; k <= 3; ++k )
+    {
+        thrower::n = k;     // 插在已满的节点：复制x、搬移后一半、构造新元素
+        thrown = false;
+        try { t.insert( t.begin(), thrower( -1 ) ); } catch( int ) { thrown = true; }
+        TEST_CHECK( thrown && t.size() == 20 );
+    }
+    thrower::n = 0;
+    int expect = 0;
+    for( unrolled_list<thrower, alloc, 3>::iterator it = t.begin(); it != t.end(); ++it )
+        TEST_CHECK( it->v == expect++ );
+    TEST_CHECK( expect == 20 );
+
+    // 比较函数抛出异常时，两个链表仍然完整，元素一个不少
+    unrolled_list<int, alloc, 3> m1, m2;
+    for( int i = 0; i < 100; ++i )
+    {
+        m1.push_back( 2 * i );
+        m2.push_back( 2 * i + 1 );
+    }
+    int count = 0;
+    thrown = false;
+    try { m1.merge( m2, [&]( int x, int y ) { if( ++count == 50 ) throw 1; return x < y; } ); }
+    catch( int ) { thrown = true; }
+    TEST_CHECK( thrown && m1.size() + m2.size() == 200 );
+    long sum = 0;
+    size_t c1 = 0, c2 = 0;
+    for( unrolled_list<int, alloc, 3>::iterator it = m1.begin(); it != m1.end(); ++it, ++c1 )
+        sum += *it;
+    for( unrolled_list<int, alloc, 3>::iterator it = m2.begin(); it != m2.end(); ++it, ++c2 )
+        sum += *it;
+    TEST_CHECK( c1 == m1.size() && c2 == m2.size() && sum == 199 * 200 / 2 );
+    // 复制抛出异常时也一样，输入节点中剩下的元素搬回节点开头
+    for( int k = 1; k < 60; k += 4 )
+    {
+        unrolled_list<thrower, alloc, 4> x1, x2;
+        for( int i = 0; i < 30; ++i )
+        {
+            x1.push_back( thrower( 2 * i ) );
+            x2.push_back( thrower( 2 * i + 1 ) );
+        }
+        thrower::n = k;
+        try { x1.merge( x2, []( const thrower& x, const thrower& y ) { return x.v < y.v; } ); }
+        catch( int ) {}
+        thrower::n = 0;
+        TEST_CHECK( x1.size() + x2.size() == 60 );
+        sum = 0;
+        c1 = 0;
+        for( unrolled_list<thrower, alloc, 4>::iterator it = x1.begin(); it != x1.end(); ++it, ++c1 )
+            sum += it->v;
+        for( unrolled_list<thrower, alloc, 4>::iterator it = x2.begin(); it != x2.end(); ++it, ++c1 )
+            sum += it->v;
+        TEST_CHECK( c1 == 60 && sum == 59 * 60 / 2 );
+    }
+}
+
+struct lru;
+struct timer;
+struct object : list_hook<lru>, list_hook<timer>
+{
+    int v;
+    object( int x = 0 ) : v( x ) {}
+    bool operator<( const object& x ) const { return v < x.v; }
+    bool operator==( const object& x ) const { return v == x.v; }
+};
+
+struct keyed_hook : list_hook<>
+{
+    int k, id;
+    bool operator<( const keyed_hook& x ) const { return k < x.k; }
+};
+
+void test_intrusive_list()
+{
+    std::mt19937 g( 3 );
+    std::vector<object> pool( 2000 );
+    for( int i = 0; i < 2000; ++i )
+        pool[i].v = int( g() % 100 );
+    intrusive_list<object, lru> a, b;
+    intrusive_list<object, timer> t;     // 同一个物件同时在两个链表中
+    for( int i = 0; i < 1000; ++i )
+    {
+        a.push_back( pool[i] );
+        t.push_front( pool[i] );
+    }
+    for( int i = 1000; i < 2000; ++i )
+        b.push_back( pool[i] );
+    TEST_CHECK( a.size() == 1000 && t.size() == 1000 && &t.front() == &pool[999] );
+    a.sort();
+    b.sort();
+    a.merge( b );
+    TEST_CHECK( a.size() == 2000 && b.empty() );
+    for( intrusive_list<object, lru>::iterator i = a.begin(), j = ++a.begin(); j != a.end(); ++i, ++j )
+        TEST_CHECK( !( *j < *i ) );
+    a.splice( a.begin(), a, intrusive_list<object, lru>::iterator_to( pool[1500] ) );
+    TEST_CHECK( &a.front() == &pool[1500] );
+    a.reverse();
+    TEST_CHECK( &a.back() == &pool[1500] );
+    a.erase( intrusive_list<object, lru>::iterator_to( pool[1500] ) );
+    TEST_CHECK( !static_cast<list_hook<lru>&>( pool[1500] ).is_linked() && a.size() == 1999 );
+    a.clear();
+    TEST_CHECK( !static_cast<list_hook<lru>&>( pool[3] ).is_linked() && t.size() == 1000 );
+
+    // 稳定排序
+    std::vector<keyed_hook> ps( 9000 );
+    intrusive_list<keyed_hook> pl;
+    for( int i = 0; i < 9000; ++i )
+    {
+        ps[i].k = int( g() % 7 );
+        ps[i].id = i;
+        pl.push_back( ps[i] );
+    }
+    pl.sort();
+    int pk = -1, pid = -1;
+    for( intrusive_list<keyed_hook>::iterator it = pl.begin(); it != pl.end(); ++it )
+    {
+        TEST_CHECK( it->k > pk || ( it->k == pk && it->id > pid ) );
+        pk = it->k;
+        pid = it->id;
+    }
+    pl.clear();
+}
+
+int main()
+{
+    run_against_std< list<int> >( 2, make_int );
+    run_against_std< list<std::string> >( 3, make_string );
+    run_against_std< unrolled_list<int> >( 4, make_int );
+    run_against_std< unrolled_list<int, alloc, 1> >( 5, make_int );
+    run_against_std< unrolled_list<int, alloc, 3> >( 6, make_int );
+    run_against_std< unrolled_list<std::string, alloc, 5> >( 7, make_string );
+    test_copy();
+    test_unrolled_list();
+    test_sort();
+    test_node_cache();
+    test_remove_if();
+    test_prefetch();
+    test_intrusive_list();
+    puts( "ok" );
+    return 0;
+}
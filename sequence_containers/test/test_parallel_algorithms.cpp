@@ -0,0 +1,164 @@
+//
+// 平行算法：vector与deque上的for_each、reduce、transform、copy、fill、sort，
+// deque的分块对齐到缓冲区，任务的异常传回调用者
+//
+
+#include "parallel_algorithms.h"
+#include "test/test.h"
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+typedef std::pair<int, int> keyed;
+
+bool key_less( const keyed& a, const keyed& b ) { return a.first < b.first; }
+
+void test_bounds( LYH::thread_pool& pool )
+{
+    deque<int> d;
+    for( int i = 0; i < 100003; ++i )
+        d.push_back( i );
+    d.pop_front();  // 头不在缓冲区的开头
+    d.pop_front();
+    d.pop_front();
+    vector<ptrdiff_t> b;
+    LYH::__parallel_bounds( d.begin(), d.end(), LYH::grain_partitioner( 1000 ), pool, b );
+    TEST_CHECK( b.front() == 0 && b.back() == ptrdiff_t( d.size() ) );
+    for( size_t i = 1; i + 1 < b.size(); ++i )
+        TEST_CHECK( ( d.begin() + b[i] ).cur == ( d.begin() + b[i] ).buf_first() );
+}
+
+void test_elementwise( LYH::thread_pool& pool )
+{
+    const int n = 100003;
+    vector<int> v( n, 0 );
+    for( int i = 0; i < n; ++i )
+        v[i] = int( ( i * 7919L ) % n );
+    deque<int> d;
+    for( int i = 0; i < n; ++i )
+        d.push_back( int( ( i * 104729L ) % n ) );
+    d.pop_front();
+
+    std::atomic<long> count( 0 );
+    LYH::parallel_for_each( v.begin(), v.end(), [&]( int& x ) { x += 1; ++count; }, LYH::static_partitioner(), pool );
+    TEST_CHECK( count == n );
+    LYH::parallel_for_each( d.begin(), d.end(), []( int& x ) { x += 1; }, LYH::grain_partitioner( 100 ), pool );
+
+    long sv = 0, sd = 0;
+    for( int i = 0; i < n; ++i )
+        sv += v[i];
+    for( size_t i = 0; i < d.size(); ++i )
+        sd += d[i];
+    TEST_CHECK( LYH::parallel_reduce( v.begin(), v.end(), 0L, std::plus<long>(), LYH::grain_partitioner( 777 ), pool ) == sv );
+    TEST_CHECK( LYH::parallel_reduce( d.begin(), d.end(), 5L, std::plus<long>(), LYH::auto_partitioner(), pool ) == sd + 5 );
+    TEST_CHECK( LYH::parallel_reduce( v.begin(), v.begin(), 3L ) == 3 );
+
+    vector<int> w( n, 0 );
+    LYH::parallel_transform( v.begin(), v.end(), w.begin(), []( int x ) { return x * 2; }, LYH::grain_partitioner( 333 ), pool );
+    for( int i = 0; i < n; ++i )
+        TEST_CHECK( w[i] == v[i] * 2 );
+
+    deque<int> d2( d.size(), 0 );
+    LYH::parallel_copy( d.begin(), d.end(), d2.begin(), LYH::grain_partitioner( 50 ), pool );
+    for( size_t i = 0; i < d.size(); ++i )
+        TEST_CHECK( d2[i] == d[i] );
+    LYH::parallel_copy( v.begin(), v.begin() + 1000, d2.begin() + 1, LYH::grain_partitioner( 99 ), pool );
+    for( size_t i = 0; i < 1000; ++i )
+        TEST_CHECK( d2[i + 1] == v[i] );
+
+    LYH::parallel_fill( w.begin(), w.end(), 9, LYH::grain_partitioner( 1000 ), pool );
+    for( int i = 0; i < n; ++i )
+        TEST_CHECK( w[i] == 9 );
+    LYH::parallel_fill( d2.begin() + 5, d2.end(), -1 );
+    for( size_t i = 5; i < d2.size(); ++i )
+        TEST_CHECK( d2[i] == -1 );
+}
+
+// 各种大小与分块，包括每块只有一个元素(合并一路切到两个元素为止)
+template <class Container>
+void check_sort( LYH::thread_pool& pool, std::mt19937& g, size_t n, size_t grain )
+{
+    Container c;
+    std::vector<keyed> ref;
+    for( size_t i = 0; i < n; ++i )
+    {
+        keyed x( int( g() % 50 ), int( i ) );
+        c.push_back( x );
+        ref.push_back( x );
+    }
+    LYH::parallel_sort( c.begin(), c.end(), key_less, LYH::grain_partitioner( grain ), pool );
+    std::stable_sort( ref.begin(), ref.end(), key_less );
+    TEST_CHECK( c.size() == n );
+    for( size_t i = 0; i < n; ++i )
+        TEST_CHECK( c[i].first == ref[i].first );
+    // 排序只交换元素，不会遗漏或重复
+    std::vector<int> ids;
+    for( size_t i = 0; i < n; ++i )
+        ids.push_back( c[i].second );
+    std::sort( ids.begin(), ids.end() );
+    for( size_t i = 0; i < n; ++i )
+        TEST_CHECK( ids[i] == int( i ) );
+}
+
+void test_sort( LYH::thread_pool& pool )
+{
+    std::mt19937 g( 1 );
+    const size_t sizes[] = { 0, 1, 2, 100, 5000, 100000 };
+    const size_t grains[] = { 1, 7, 1000, 50000 };
+    for( size_t n : sizes )
+        for( size_t grain : grains )
+        {
+            if( grain == 1 && n > 5000 )
+                continue;
+            check_sort< vector<keyed> >( pool, g, n, grain );
+            check_sort< deque<keyed> >( pool, g, n, grain );
+        }
+
+    deque<int> d;
+    for( int i = 0; i < 100000; ++i )
+        d.push_back( int( g() ) );
+    LYH::parallel_sort( d.begin(), d.end(), std::greater<int>(), LYH::grain_partitioner( 3000 ), pool );
+    for( size_t i = 1; i < d.size(); ++i )
+        TEST_CHECK( d[i - 1] >= d[i] );
+    // 头落在缓冲区的最后一个位置，第一块只有一个元素
+    for( size_t i = 0; i < deque<int>::buffer_size() - 1; ++i )
+        d.pop_front();
+    LYH::parallel_sort( d.begin(), d.end(), std::less<int>(), LYH::grain_partitioner( 3000 ), pool );
+    for( size_t i = 1; i < d.size(); ++i )
+        TEST_CHECK( d[i - 1] <= d[i] );
+    vector<int> v( 10000, 0 );
+    for( size_t i = 0; i < v.size(); ++i )
+        v[i] = int( g() );
+    LYH::parallel_sort( v.begin(), v.end() );
+    for( size_t i = 1; i < v.size(); ++i )
+        TEST_CHECK( v[i - 1] <= v[i] );
+}
+
+void test_exception( LYH::thread_pool& pool )
+{
+    vector<int> v( 10000, 0 );
+    for( int i = 0; i < 10000; ++i )
+        v[i] = i;
+    bool thrown = false;
+    try
+    {
+        LYH::parallel_for_each( v.begin(), v.end(), []( int& x ) { if( x == 500 ) throw std::runtime_error( "x" ); },
+                                LYH::grain_partitioner( 100 ), pool );
+    }
+    catch( std::runtime_error& ) { thrown = true; }
+    TEST_CHECK( thrown );
+}
+
+int main()
+{
+    LYH::thread_pool pool( 4 );
+    test_bounds( pool );
+    test_elementwise( pool );
+    test_sort( pool );
+    test_exception( pool );
+    puts( "ok" );
+    return 0;
+}
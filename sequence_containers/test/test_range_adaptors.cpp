@@ -0,0 +1,122 @@
+//
+// 惰性的区间转接器：filtered、transformed、taken、zipped、chunked
+// 检查结果与迭代器分类(转接之后仍保留原来容器迭代器能支持的最强分类)
+//
+
+#include "sequence_containers.h"
+#include "range_adaptors.h"
+#include "test/test.h"
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+template <class Range>
+std::vector<int> collect( Range r )
+{
+    std::vector<int> out;
+    for( auto x : r )
+        out.push_back( x );
+    return out;
+}
+
+template <class Iterator>
+struct category_of
+{
+    typedef typename LYH::iterator_traits<Iterator>::iterator_category type;
+};
+
+int main()
+{
+    vector<int> v;
+    list<int> l;
+    deque<int> d;
+    for( int i = 0; i < 100; ++i )
+    {
+        v.push_back( i );
+        l.push_back( i );
+        d.push_back( i );
+    }
+    auto sq = []( int x ) { return x * x; };
+    auto odd = []( int x ) { return x % 2 == 1; };
+
+    // 串接起来的管线，一次走访，不建立暂时的容器
+    TEST_CHECK( ( collect( v | filtered( odd ) | transformed( sq ) | taken( 5 ) ) == std::vector<int>{ 1, 9, 25, 49, 81 } ) );
+    TEST_CHECK( ( collect( l | filtered( odd ) | transformed( sq ) | taken( 3 ) ) == std::vector<int>{ 1, 9, 25 } ) );
+
+    // transformed保留随机存取，taken在随机存取时不另外包装迭代器
+    auto tr = v | transformed( sq );
+    typedef decltype( tr.begin() ) transform_iterator;
+    static_assert( std::is_same<category_of<transform_iterator>::type, std::random_access_iterator_tag>::value, "" );
+    TEST_CHECK( tr.size() == 100 && tr.begin()[7] == 49 && *( tr.end() - 1 ) == 99 * 99 );
+    TEST_CHECK( LYH::next( tr.begin(), 10 )[0] == 100 );
+    TEST_CHECK( *std::max_element( tr.begin(), tr.end() ) == 99 * 99 );
+    auto tk = v | transformed( sq ) | taken( 10 );
+    static_assert( std::is_same<decltype( tk.begin() ), transform_iterator>::value, "" );
+    TEST_CHECK( tk.size() == 10 );
+
+    // filtered最多是双向，taken对非随机存取的区间是前向
+    auto lf = l | filtered( odd );
+    static_assert( std::is_same<category_of<decltype( lf.begin() )>::type, std::bidirectional_iterator_tag>::value, "" );
+    auto e = lf.end();
+    --e;
+    TEST_CHECK( *e == 99 && lf.size() == 50 );
+    auto lt = l | taken( 200 );
+    static_assert( std::is_same<category_of<decltype( lt.begin() )>::type, std::forward_iterator_tag>::value, "" );
+    TEST_CHECK( lt.size() == 100 && ( l | taken( 7 ) ).size() == 7 );
+
+    // zipped在较短的一方结束，元素可以经由zip写回
+    vector<std::string> s;
+    for( int i = 0; i < 10; ++i )
+        s.push_back( std::to_string( i ) );
+    int count = 0;
+    for( auto p : v | zipped( s ) )
+    {
+        TEST_CHECK( std::to_string( p.first ) == p.second );
+        ++count;
+    }
+    TEST_CHECK( count == 10 );
+    auto z = zipped( v, s );
+    TEST_CHECK( z.size() == 10 && z.begin()[3].second == "3" );
+    for( auto p : zipped( l, s ) )
+        p.first = -1;
+    TEST_CHECK( l.front() == -1 && *LYH::next( l.begin(), 9 ) == -1 && *LYH::next( l.begin(), 10 ) == 10 );
+    // 两边都随机存取时尾端对齐，可以从尾端往回走；否则尾端不对齐，只能是单向
+    static_assert( std::is_same<category_of<decltype( z.begin() )>::type, std::random_access_iterator_tag>::value, "" );
+    auto ze = z.end();
+    --ze;
+    TEST_CHECK( ( *ze ).first == 9 && ( *ze ).second == "9" );
+    auto zl = zipped( l, s );
+    static_assert( std::is_same<category_of<decltype( zl.begin() )>::type, std::forward_iterator_tag>::value, "" );
+    static_assert( std::is_same<category_of<decltype( zipped( v, l ).begin() )>::type, std::forward_iterator_tag>::value, "" );
+    TEST_CHECK( zl.size() == 10 );
+
+    // chunked把区间切成固定大小的子区间，最后一块可以较小
+    auto ch = v | chunked( 30 );
+    TEST_CHECK( ch.size() == 4 && ch.end() - ch.begin() == 4 );
+    int total = 0;
+    for( auto c : ch )
+        total += int( c.size() );
+    TEST_CHECK( total == 100 );
+    auto last = ch.end();
+    --last;
+    TEST_CHECK( ( *last ).size() == 10 && *( *last ).begin() == 90 && ch.begin()[2].begin()[0] == 60 );
+    count = 0;
+    for( auto c : l | chunked( 30 ) )
+    {
+        ( void )c;
+        ++count;
+    }
+    TEST_CHECK( count == 4 );
+    auto dc = d | transformed( sq ) | chunked( 25 );
+    TEST_CHECK( dc.size() == 4 && dc.begin()[1].begin()[0] == 625 );
+
+    // const容器
+    const vector<int>& cv = v;
+    int sum = 0;
+    for( int x : cv | transformed( sq ) | taken( 3 ) )
+        sum += x;
+    TEST_CHECK( sum == 0 + 1 + 4 );
+    puts( "ok" );
+    return 0;
+}
@@ -0,0 +1,283 @@
+//
+// vector与small_vector：内嵌缓冲区、不归零的resize、SIMD填充与复制、搬移与异常安全、
+// 以memchr/memcmp实现的find/equal/lexicographical_compare
+//
+
+#include "sequence_containers.h"
+#include "test/test.h"
+#include <cstring>
+#include <string>
+#include <vector>
+
+// 可以逐位元搬移，但复制有副作用的型别：vector扩充时不应呼叫复制构造
+struct handle
+{
+    int* p;
+    static int copies;
+    handle( int v = 0 ) : p( new int( v ) ) {}
+    handle( const handle& x ) : p( new int( *x.p ) ) { ++copies; }
+    ~handle() { delete p; }
+    handle& operator=( const handle& x ) { *p = *x.p; return *this; }
+};
+int handle::copies = 0;
+namespace LYH { template <> struct is_trivially_relocatable<handle> : std::true_type {}; }
+
+// 第n次复制时抛出异常
+struct thrower
+{
+    static int n;
+    int v;
+    thrower( int x = 0 ) : v( x ) {}
+    thrower( const thrower& x ) : v( x.v ) { if( n && --n == 0 ) throw 1; }
+    thrower& operator=( const thrower& x ) { v = x.v; return *this; }
+};
+int thrower::n = 0;
+
+struct pod { int a; double b; };
+struct non_pod { std::string s; };
+static_assert( std::is_same<__type_traits<pod>::is_POD_type, __true_type>::value, "" );
+static_assert( std::is_same<__type_traits<non_pod>::is_POD_type, __false_type>::value, "" );
+static_assert( std::is_same<__type_traits<handle>::has_trivial_relocate, __true_type>::value, "" );
+static_assert( std::is_same<__type_traits<non_pod>::has_trivial_relocate, __false_type>::value, "" );
+static_assert( LYH::__is_contiguous_iterator<vector<int>::iterator>::value, "" );
+
+void test_small_vector()
+{
+    small_vector<int, 4> v;
+    TEST_CHECK( v.capacity() == 4 );
+    for( int i = 0; i < 100; ++i )
+        v.push_back( i );
+    for( int i = 0; i < 100; ++i )
+        TEST_CHECK( v[i] == i );
+
+    small_vector<std::string, 3> s;
+    s.push_back( "a" );
+    s.push_back( "b" );
+    small_vector<std::string, 3> s2( s );
+    s2.push_back( "c" );
+    s2.push_back( std::string( 40, 'd' ) );
+    s = s2;
+    TEST_CHECK( s.size() == 4 && s[3][0] == 'd' );
+
+    small_vector<pod, 4> p;
+    for( int i = 0; i < 100; ++i )
+    {
+        pod x = { i, i * 0.5 };
+        p.push_back( x );
+    }
+    TEST_CHECK( p[99].a == 99 );
+}
+
+void test_insert_erase()
+{
+    vector<int> w( 5, 7 );
+    w.insert( w.begin() + 2, 3, 1 );
+    TEST_CHECK( w.size() == 8 && w[2] == 1 && w[5] == 7 );
+    w.erase( w.begin() );
+    w.resize( 20 );
+    TEST_CHECK( w[19] == 0 );
+    w.resize( 2 );
+    TEST_CHECK( w.size() == 2 );
+
+    vector<std::string> ws;
+    for( int i = 0; i < 50; ++i )
+        ws.push_back( std::to_string( i ) );
+    ws.erase( ws.begin() + 3, ws.begin() + 10 );
+    TEST_CHECK( ws[3] == "10" && ws.size() == 43 );
+
+    vector<int> v( 1000, 5 );
+    v.insert( v.begin() + 10, 500, 9 );
+    TEST_CHECK( v[10] == 9 && v[509] == 9 && v[510] == 5 && v.size() == 1500 );
+    v.insert( v.begin() + 1, 2000, 3 );
+    TEST_CHECK( v[1] == 3 && v[2001] == 5 );
+}
+
+void test_default_init()
+{
+    vector<char> b( 10, default_init );
+    TEST_CHECK( b.size() == 10 );
+    b.resize_uninitialized( 1000 );
+    TEST_CHECK( b.size() == 1000 );
+    vector<float> f( 100 );
+    for( int i = 0; i < 100; ++i )
+        TEST_CHECK( f[i] == 0.0f );
+    vector<std::string> s( 5, default_init );
+    TEST_CHECK( s[4].empty() );
+    s.resize_default_init( 40 );
+    TEST_CHECK( s.size() == 40 && s[39].empty() );
+    small_vector<int, 8> sv( 4, default_init );
+    sv.resize_default_init( 6 );
+    TEST_CHECK( sv.size() == 6 && sv.capacity() == 8 );
+}
+
+// 一组核心(纯量、AVX2、AVX-512)与memset、memmove对照，涵盖未对齐的头尾与重叠的复制
+void check_kernels( const LYH::__simd_kernels& k )
+{
+    const size_t sizes[] = { 0, 1, 3, 31, 33, 64, 100, 257, 1000, 100000 };
+    for( size_t n : sizes )
+        for( size_t off = 0; off < 4; ++off )
+        {
+            std::vector<int> buf( n + off + 8, 7 );
+            unsigned char pat[64];
+            const int x = 0x12345678;
+            for( size_t i = 0; i < 64; i += sizeof( int ) )
+                std::memcpy( pat + i, &x, sizeof( int ) );
+            k.fill( buf.data() + off, n * sizeof( int ), pat );
+            for( size_t i = 0; i < buf.size(); ++i )
+                TEST_CHECK( buf[i] == ( i >= off && i < off + n ? x : 7 ) );
+
+            std::vector<int> a( n + 200 );
+            for( size_t i = 0; i < a.size(); ++i )
+                a[i] = int( i );
+            std::vector<int> ref = a, fwd = a, bwd = a;
+            // 往前重叠用copy，往后重叠用copy_backward
+            std::memmove( ref.data() + 100 - off - 1, ref.data() + 100, n * sizeof( int ) );
+            k.copy( fwd.data() + 100 - off - 1, fwd.data() + 100, n * sizeof( int ) );
+            TEST_CHECK( ref == fwd );
+            ref = a;
+            std::memmove( ref.data() + 100 + off + 1, ref.data() + 100, n * sizeof( int ) );
+            k.copy_backward( bwd.data() + 100 + off + 1 + n, bwd.data() + 100 + n, n * sizeof( int ) );
+            TEST_CHECK( ref == bwd );
+        }
+    // 超过LYH_SIMD_STREAM_BYTES且不重叠时走non-temporal store
+    std::vector<char> x( LYH_SIMD_STREAM_BYTES + 4096 ), y( x.size() );
+    for( size_t i = 0; i < x.size(); ++i )
+        x[i] = char( i * 31 );
+    k.copy( y.data() + 3, x.data() + 1, x.size() - 8 );
+    TEST_CHECK( std::memcmp( y.data() + 3, x.data() + 1, x.size() - 8 ) == 0 );
+}
+
+void test_simd_kernels()
+{
+    const LYH::__simd_kernels scalar = { LYH::__fill_bytes_scalar, LYH::__copy_bytes_scalar,
+                                         LYH::__copy_backward_bytes_scalar, "scalar" };
+    check_kernels( scalar );
+#ifdef __LYH_SIMD_X86
+    // 机器不支持的指令集跳过
+    if( __builtin_cpu_supports( "avx2" ) )
+    {
+        const LYH::__simd_kernels avx2 = { LYH::__fill_bytes_avx2, LYH::__copy_bytes_avx2,
+                                           LYH::__copy_backward_bytes_avx2, "avx2" };
+        check_kernels( avx2 );
+    }
+    if( __builtin_cpu_supports( "avx512f" ) )
+    {
+        const LYH::__simd_kernels avx512 = { LYH::__fill_bytes_avx512, LYH::__copy_bytes_avx512,
+                                             LYH::__copy_backward_bytes_avx512, "avx512" };
+        check_kernels( avx512 );
+    }
+#endif
+    // 经由一般的fill、copy走到核心
+    long a[300];
+    LYH::fill( a, a + 300, 5 );
+    for( long x : a )
+        TEST_CHECK( x == 5 );
+    short s[100];
+    LYH::fill( s, s + 100, 70000 );
+    for( short x : s )
+        TEST_CHECK( x == short( 70000 ) );
+}
+
+void test_relocate()
+{
+    {
+        vector<handle> v;
+        for( int i = 0; i < 1000; ++i )
+            v.push_back( handle( i ) );
+        const int c = handle::copies;
+        TEST_CHECK( c == 1000 );    // 只有push_back本身的复制，扩充时逐位元搬移
+        v.insert( v.begin() + 3, 100, handle( 7 ) );
+        TEST_CHECK( handle::copies == c + 100 && *v[3].p == 7 && *v[103].p == 3 && *v[1099].p == 999 );
+    }
+    {
+        vector<std::string> v;
+        for( int i = 0; i < 1000; ++i )
+            v.push_back( std::to_string( i ) );
+        v.insert( v.begin() + 500, 700, std::string( "x" ) );
+        TEST_CHECK( v[499] == "499" && v[1200] == "500" && v.size() == 1700 );
+        v.push_back( v[0] );    // 引用自身的元素，扩充时不能先释放旧空间
+        TEST_CHECK( v.back() == "0" );
+    }
+    {
+        // 复制中途抛出异常时，vector保持原样
+        vector<thrower> v;
+        for( int i = 0; i < 8; ++i )
+            v.push_back( thrower( i ) );
+        thrower::n = 5;
+        bool thrown = false;
+        try { v.push_back( thrower( 99 ) ); } catch( int ) { thrown = true; }
+        TEST_CHECK( thrown && v.size() == 8 && v[7].v == 7 && v.capacity() == 8 );
+        thrower::n = 3;
+        thrown = false;
+        try { v.insert( v.begin() + 2, 4, thrower( 5 ) ); } catch( int ) { thrown = true; }
+        TEST_CHECK( thrown && v.size() == 8 && v[2].v == 2 );
+        // 赋值需要重新配置时，复制失败不影响原内容
+        vector<thrower> w;
+        for( int i = 0; i < 20; ++i )
+            w.push_back( thrower( 100 + i ) );
+        thrower::n = 12;
+        thrown = false;
+        try { v = w; } catch( int ) { thrown = true; }
+        TEST_CHECK( thrown && v.size() == 8 && v[7].v == 7 && v.capacity() == 8 );
+        thrower::n = 0;
+        v = w;
+        TEST_CHECK( v.size() == 20 && v[19].v == 119 );
+    }
+}
+
+enum color { red, green, blue };
+
+void test_find_equal()
+{
+    char s[] = "hello world";
+    TEST_CHECK( LYH::find( s, s + 11, 'w' ) == s + 6 );
+    TEST_CHECK( LYH::find( s, s + 11, 300 ) == s + 11 );     // 超出char的范围，不可截断
+    TEST_CHECK( LYH::find( s, s + 11, 'z' ) == s + 11 );
+    unsigned char u[4] = { 1, 255, 3, 4 };
+    TEST_CHECK( LYH::find( u, u + 4, -1 ) == u + 4 && LYH::find( u, u + 4, 255 ) == u + 1 );
+    signed char sc[3] = { 1, -1, 2 };
+    TEST_CHECK( LYH::find( sc, sc + 3, -1 ) == sc + 1 );
+    std::string ss[3] = { "a", "b", "c" };
+    TEST_CHECK( LYH::find( ss, ss + 3, std::string( "b" ) ) == ss + 1 );
+
+    int ia[5] = { 1, 2, 3, 4, 5 }, ib[5] = { 1, 2, 3, 4, 5 };
+    const int* cib = ib;
+    TEST_CHECK( LYH::equal( ia, ia + 5, cib ) );
+    ib[4] = 6;
+    TEST_CHECK( !LYH::equal( ia, ia + 5, ib ) && LYH::equal( ia, ia, ib ) );
+    double d1[2] = { 0.0, 1 }, d2[2] = { -0.0, 1 };     // 浮点数不能逐位元比较
+    TEST_CHECK( LYH::equal( d1, d1 + 2, d2 ) );
+    color e1[2] = { red, blue }, e2[2] = { red, blue };
+    TEST_CHECK( LYH::equal( e1, e1 + 2, e2 ) );
+
+    unsigned char x1[3] = { 1, 2, 200 }, x2[3] = { 1, 2, 3 };
+    TEST_CHECK( !LYH::lexicographical_compare( x1, x1 + 3, x2, x2 + 3 ) );
+    TEST_CHECK( LYH::lexicographical_compare( x2, x2 + 3, x1, x1 + 3 ) );
+    TEST_CHECK( LYH::lexicographical_compare( x1, x1 + 2, x1, x1 + 3 ) );
+    TEST_CHECK( !LYH::lexicographical_compare( x1, x1 + 3, x1, x1 + 2 ) );
+    char c1[2] = { 1, char( -56 ) }, c2[2] = { 1, 3 };
+    TEST_CHECK( LYH::lexicographical_compare( c1, c1 + 2, c2, c2 + 2 ) ==
+                std::lexicographical_compare( c1, c1 + 2, c2, c2 + 2 ) );
+
+    vector<int> v1, v2;
+    for( int i = 0; i < 100; ++i )
+    {
+        v1.push_back( i );
+        v2.push_back( i );
+    }
+    TEST_CHECK( v1 == v2 );
+    v2.back() = 0;
+    TEST_CHECK( v1 != v2 && v2 < v1 );
+}
+
+int main()
+{
+    test_small_vector();
+    test_insert_erase();
+    test_default_init();
+    test_simd_kernels();
+    test_relocate();
+    test_find_equal();
+    puts( "ok" );
+    return 0;
+}
@@ -0,0 +1,276 @@
+//
+// 任务池，供容器的并行算法使用
+//
+
+#ifndef SEQUENCE_CONTAINERS_THREAD_POOL_H
+#define SEQUENCE_CONTAINERS_THREAD_POOL_H
+
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LYH
+{
+    class thread_pool;
+
+    // 一组相关的任务，wait()等待组内所有任务结束
+    // 等待的线程不会睡眠，而是帮忙执行池中的任务，
+    // 因此任务中可以再建立task_group、提交子任务并等待(递归分治)而不会死锁
+    class task_group
+    {
+    public:
+        explicit task_group( thread_pool& p ) : pool(p), pending(0) {}
+        // 任务可能引用了调用者的局部变量，离开前必须等它们结束
+        ~task_group() { help_until_done(); }
+
+        // 提交一个任务
+        template <class F>
+        void run( F f );
+        // 等待所有任务结束，任务抛出的第一个异常在这里重新抛出
+        void wait()
+        {
+            help_until_done();
+            if( error )
+            {
+                std::exception_ptr e = error;
+                error = std::exception_ptr();
+                std::rethrow_exception( e );
+            }
+        }
+
+    private:
+        friend class thread_pool;
+
+        thread_pool& pool;
+        std::atomic<size_t> pending;    // 尚未结束的任务数
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        void help_until_done();
+        // 一个任务结束，pending最后才减，减完之后task_group可能已被销毁
+        void finish_one( std::exception_ptr e )
+        {
+            if( e )
+            {
+                std::lock_guard<std::mutex> lock( error_mutex );
+                if( !error )
+                    error = e;
+            }
+            pending.fetch_sub( 1, std::memory_order_release );
+        }
+
+        task_group( const task_group& );
+        task_group& operator=( const task_group& );
+    };
+
+    // 工作窃取的线程池
+    // 每个工作线程有自己的任务队列：自己从尾端取(最近提交的，数据还在cache中)，
+    // 空了再从其他线程的队列前端窃取(最早提交的，通常是最大的一块工作)
+    class thread_pool
+    {
+    public:
+        // n为工作线程数，缺省为硬件线程数
+        explicit thread_pool( size_t n = std::thread::hardware_concurrency() )
+            : queued(0), next_queue(0), stop(false)
+        {
+            if( n == 0 )
+                n = 1;
+            for( size_t i = 0; i < n; ++i )
+                queues.push_back( new worker_queue );
+            for( size_t i = 0; i < n; ++i )
+                threads.push_back( std::thread( &thread_pool::worker_loop, this, i ) );
+        }
+        // 执行完所有剩余的任务后才结束工作线程
+        ~thread_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock( sleep_mutex );
+                stop = true;
+            }
+            sleep_cv.notify_all();
+            for( size_t i = 0; i < threads.size(); ++i )
+                threads[i].join();
+            for( size_t i = 0; i < queues.size(); ++i )
+                delete queues[i];
+        }
+
+        // 工作线程数
+        size_t size() const { return threads.size(); }
+
+        // 提交一个不属于任何task_group的任务，不等待它结束，任务抛出的异常被忽略
+        // 池销毁前会执行完所有这样的任务
+        template <class F>
+        void post( F f )
+        {
+            task t;
+            t.fn = f;
+            t.group = 0;
+            push( t );
+        }
+
+    private:
+        friend class task_group;
+
+        struct task
+        {
+            std::function<void()> fn;
+            task_group* group;
+        };
+        struct worker_queue
+        {
+            std::mutex m;
+            std::deque<task> q;
+        };
+
+        std::vector<worker_queue*> queues;
+        std::vector<std::thread> threads;
+        std::atomic<size_t> queued;         // 所有队列中的任务总数
+        std::atomic<size_t> next_queue;     // 外部线程提交时轮流选择队列
+        std::mutex sleep_mutex;
+        std::condition_variable sleep_cv;
+        bool stop;
+
+        static const size_t npos = size_t(-1);
+
+        // 当前线程所属的池与它在池中的编号
+        static thread_pool*& current_pool()
+        {
+            static thread_local thread_pool* p = 0;
+            return p;
+        }
+        static size_t& current_index()
+        {
+            static thread_local size_t i = npos;
+            return i;
+        }
+        // 当前线程在本池中的编号，不是本池的工作线程则为npos
+        size_t self_index() const
+        {
+            return current_pool() == this ? current_index() : npos;
+        }
+
+        // 工作线程提交的任务放进自己的队列，外部线程提交的轮流放
+        void push( const task& t )
+        {
+            size_t i = self_index();
+            if( i == npos )
+                i = next_queue.fetch_add( 1, std::memory_order_relaxed ) % queues.size();
+            {
+                std::lock_guard<std::mutex> lock( queues[i]->m );
+                queues[i]->q.push_back( t );
+            }
+            queued.fetch_add( 1, std::memory_order_release );
+            // 先取得sleep_mutex再通知，工作线程在检查条件与睡眠之间不会错过通知
+            {
+                std::lock_guard<std::mutex> lock( sleep_mutex );
+            }
+            sleep_cv.notify_one();
+        }
+
+        // 先取自己队列的尾端，再依次窃取其他队列的前端
+        bool pop( size_t self, task& t )
+        {
+            size_t n = queues.size();
+            if( self != npos )
+            {
+                std::lock_guard<std::mutex> lock( queues[self]->m );
+                if( !queues[self]->q.empty() )
+                {
+                    t = queues[self]->q.back();
+                    queues[self]->q.pop_back();
+                    queued.fetch_sub( 1, std::memory_order_relaxed );
+                    return true;
+                }
+            }
+            size_t start = self == npos ? 0 : self + 1;
+            for( size_t k = 0; k < n; ++k )
+            {
+                size_t i = ( start + k ) % n;
+                if( i == self )
+                    continue;
+                std::lock_guard<std::mutex> lock( queues[i]->m );
+                if( !queues[i]->q.empty() )
+                {
+                    t = queues[i]->q.front();
+                    queues[i]->q.pop_front();
+                    queued.fetch_sub( 1, std::memory_order_relaxed );
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // 取出并执行一个任务，没有任务可做时传回false
+        bool run_one( size_t self )
+        {
+            task t;
+            if( !pop( self, t ) )
+                return false;
+            std::exception_ptr e;
+            try
+            {
+                t.fn();
+            }
+            catch(...)
+            {
+                e = std::current_exception();
+            }
+            if( t.group != 0 )
+                t.group->finish_one( e );
+            return true;
+        }
+
+        void worker_loop( size_t i )
+        {
+            current_pool() = this;
+            current_index() = i;
+            for( ; ; )
+            {
+                if( run_one( i ) )
+                    continue;
+                std::unique_lock<std::mutex> lock( sleep_mutex );
+                sleep_cv.wait( lock, [this]{ return stop || queued.load( std::memory_order_acquire ) != 0; } );
+                if( stop && queued.load( std::memory_order_acquire ) == 0 )
+                    return;
+            }
+        }
+
+        thread_pool( const thread_pool& );
+        thread_pool& operator=( const thread_pool& );
+    };
+
+    template <class F>
+    inline void task_group::run( F f )
+    {
+        pending.fetch_add( 1, std::memory_order_relaxed );
+        thread_pool::task t;
+        t.fn = f;
+        t.group = this;
+        pool.push( t );
+    }
+
+    inline void task_group::help_until_done()
+    {
+        size_t self = pool.self_index();
+        while( pending.load( std::memory_order_acquire ) != 0 )
+        {
+            if( !pool.run_one( self ) )
+                std::this_thread::yield();
+        }
+    }
+
+    // 缺省的任务池，第一次使用时建立，线程数为硬件线程数
+    inline thread_pool& default_thread_pool()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+}
+
+#endif //SEQUENCE_CONTAINERS_THREAD_POOL_H
@@ -0,0 +1,58 @@
+//
+// 型别特性__type_traits，算法据此在编译期选择做法
+//
+
+#ifndef SEQUENCE_CONTAINERS_TYPE_TRAITS_H
+#define SEQUENCE_CONTAINERS_TYPE_TRAITS_H
+
+#include <type_traits>
+
+namespace LYH
+{
+    // 两个标记用的型别，作为函数参数参与重载决议，在编译期选择做法
+    struct __true_type {};
+    struct __false_type {};
+
+    // bool常量转换为标记型别
+    template <bool B>
+    struct __bool_type { typedef __false_type type; };
+    template <>
+    struct __bool_type<true> { typedef __true_type type; };
+
+    // 元素能否以逐字节复制的方式搬到别处，且原位置不必析构(trivially relocatable)
+    // 缺省只有trivially copyable的型别成立；
+    // 没有指向自身的指针、也不在别处登记自身地址的class(例如只持有一个堆指针的handle)
+    // 可以特化为std::true_type，vector重新配置空间时即改为整块memcpy，省去复制与析构
+    template <class T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    // SGI的__type_traits原本只为内建型别逐一特化，用户定义的struct一律是__false_type，
+    // 走不到任何快速路径；这里改由编译器的型别判断(std::is_trivially_*)推导，
+    // 用户的POD struct自动取得memcpy、memset与不做事的destroy
+    // 仍然可以像SGI一样为个别型别特化__type_traits
+    template <class T>
+    struct __type_traits
+    {
+        typedef __true_type this_dummy_member_must_be_first;
+
+        typedef typename __bool_type< std::is_trivially_default_constructible<T>::value >::type
+                has_trivial_default_constructor;
+        typedef typename __bool_type< std::is_trivially_copyable<T>::value
+                                      && std::is_trivially_copy_constructible<T>::value >::type
+                has_trivial_copy_constructor;
+        typedef typename __bool_type< std::is_trivially_copyable<T>::value
+                                      && std::is_trivially_copy_assignable<T>::value >::type
+                has_trivial_assignment_operator;
+        typedef typename __bool_type< std::is_trivially_destructible<T>::value >::type
+                has_trivial_destructor;
+        // POD：复制等同于逐字节复制，默认初始化什么都不做
+        typedef typename __bool_type< std::is_trivially_copyable<T>::value
+                                      && std::is_trivially_default_constructible<T>::value >::type
+                is_POD_type;
+        // 搬移等同于逐字节复制，原位置不必析构
+        typedef typename __bool_type< is_trivially_relocatable<T>::value >::type
+                has_trivial_relocate;
+    };
+}
+
+#endif //SEQUENCE_CONTAINERS_TYPE_TRAITS_H